@@ -33,10 +33,10 @@
 // ANSI C/C++ includes
 #include <algorithm>
 #include <cerrno>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <ctime>
 #include <iostream>
 #include <list>
 #include <sstream>
@@ -47,45 +47,277 @@
 // EPICS includes
 #include <alarm.h>
 #include <dbAccess.h>
+#include <dbLock.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <drvSup.h>
 #include <errlog.h>
+#include <epicsAtomic.h>
 #include <epicsExport.h>
 #include <epicsThread.h>
 #include <epicsTypes.h>
 #include <iocLog.h>
+#include <initHooks.h>
 #include <iocsh.h>
+#include <menuFtype.h>
+#include <menuScan.h>
 #include <recGbl.h>
 
 // local includes
 #include "devIsegHalClasses.hpp"
+#include "devIsegHalParse.h"
 
 //_____ D E F I N I T I O N S __________________________________________________
 
 //_____ G L O B A L S __________________________________________________________
 
 //_____ L O C A L S ____________________________________________________________
-static isegHalThread* myIsegHalThread = NULL;
+
+//! Maximum number of queued writes per interface
+static const size_t writeQueueDepth = 1000;
+
+//! Default time in seconds to wait for isegHAL to be ready after connect
+static const double connectTimeout = 30.;
+
+//! Time in seconds between two readiness probes after connect
+static const double readyProbe = 0.05;
+
+//! Time in seconds to wait for the module lists after connect, before
+//! isegHAL is considered ready after two collection cycles
+static const double listTimeout = 5.;
+
+//! Number of lines probed for their module lists after connect
+static const unsigned maxLines = 8;
 
 //_____ F U N C T I O N S ______________________________________________________
-double timespec_diff( const struct timespec * stop, const struct timespec * start )
-{
-  long	start_sec	= start->tv_sec;
-  long	start_nsec	= start->tv_nsec;
 
-  if ( stop->tv_nsec < start_nsec ) {
-    long	nSeconds = ( start_nsec - stop->tv_nsec ) / 1e9 + 1;
-    start_nsec -= 1e9 * nSeconds;
-    start_sec  += nSeconds;
+//------------------------------------------------------------------------------
+//! @brief       Called when the scan of a scan group has been completed
+//! @param [in]  usr   Address of the scan group
+//! @param [in]  pvt   I/O Intr scan list of the group
+//! @param [in]  prio  Priority of the completed scan
+//!
+//! Wakes up the polling thread if updates for the group have been
+//! deferred while the scan was in flight.
+//------------------------------------------------------------------------------
+static void scanGroupComplete( void* usr, IOSCANPVT pvt, int prio ) {
+  isegHalScanGroup* pgroup = static_cast< isegHalScanGroup* >( usr );
+  if( epicsAtomicDecrIntT( &pgroup->inFlight ) <= 0 && epicsAtomicGetIntT( &pgroup->pending ) ) pgroup->pthread->wakeup();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Process an output record to update its readback value
+//! @param [in]  pinfo  Address of the record's private data structure
+//!
+//! The flag is set under the scan lock of the record, so the write routine
+//! can tell the readback apart from any other processing (put, FLNK, DOL, ...).
+//------------------------------------------------------------------------------
+void processReadback( devIsegHal_info_t* pinfo ) {
+  dbScanLock( pinfo->prec );
+  pinfo->inReadback = true;
+  dbProcess( pinfo->prec );
+  pinfo->inReadback = false;
+  dbScanUnlock( pinfo->prec );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Callback processing an output record with a pending readback
+//! @param [in]  pcallback  Address of the readback callback of the record
+//------------------------------------------------------------------------------
+static void readbackCallback( CALLBACK* pcallback ) {
+  void* pusr = NULL;
+  callbackGetUser( pusr, pcallback );
+  processReadback( static_cast< devIsegHal_info_t* >( pusr ) );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Raise the alarm of a failed write within the write window
+//! @param [in]  prec   Address of the record
+//! @param [in]  pinfo  Address of the record's private data structure
+//! @return      true if a failed write was reported, otherwise false
+//!
+//! Writes within the write window complete the record immediately, so
+//! their errors are latched by the writer thread and reported by the next
+//! processing of the record.
+//------------------------------------------------------------------------------
+static bool windowWriteFailed( dbCommon* prec, devIsegHal_info_t* pinfo ) {
+  if( !epicsAtomicCmpAndSwapIntT( &pinfo->windowError, 1, 0 ) ) return false;
+  fprintf( stderr, "\033[31;1m%s: Write to '%s' within the write window failed (%lu failed writes)\033[0m\n",
+           prec->name, pinfo->object, (unsigned long)epicsAtomicGetSizeT( &pinfo->writeErrors ) );
+  recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get value of an info tag of a record
+//! @param [in]  prec  Address of the record
+//! @param [in]  name  Name of the info tag
+//! @return      Value of the info tag, empty string if not defined
+//------------------------------------------------------------------------------
+static std::string getInfoTag( dbCommon* prec, const char* name ) {
+  std::string value;
+  DBENTRY entry;
+  dbInitEntry( pdbbase, &entry );
+  if( 0 == dbFindRecord( &entry, prec->name ) && 0 == dbFindInfo( &entry, name ) ) {
+    const char* pvalue = dbGetInfoString( &entry );
+    if( pvalue ) value = pvalue;
+  }
+  dbFinishEntry( &entry );
+  return value;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the poll class of a record
+//! @param [in]  prec     Address of the record
+//! @param [in]  options  Space separated options of the link
+//! @return      Address of the poll class, NULL if the class is not defined
+//!
+//! The poll class is given by the third option of the link or by the
+//! info tag "isegPollClass", records without one use the class "default".
+//------------------------------------------------------------------------------
+static isegHalPollClass* recordPollClass( dbCommon* prec, std::vector< std::string > const& options ) {
+  std::string name = ( options.size() == 3 ) ? options.at(2) : getInfoTag( prec, "isegPollClass" );
+  if( name.empty() ) name = "default";
+  isegHalPollClass* pclass = isegHalConnectionHandler::instance().poller( options.at(1) )->pollClass( name );
+  if( !pclass ) {
+    fprintf( stderr, "\033[31;1m%s: Unknown poll class '%s', define it with devIsegHalSetOpt( \"%s\", \"Intervall:%s\", PERIOD )\033[0m\n",
+             prec->name, name.c_str(), options.at(1).c_str(), name.c_str() );
+  }
+  return pclass;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Split the INP/OUT link of a record into its options
+//! @param [in]  prec     Address of the record
+//! @param [in]  pconf    Address of record configuration
+//! @param [out] options  Space separated options of the link
+//! @return      false if the link is not an INST_IO link, otherwise true
+//------------------------------------------------------------------------------
+static bool splitLink( dbCommon* prec, const devIsegHal_rec_t* pconf, std::vector< std::string >& options ) {
+  if( INST_IO != pconf->ioLink->type ) {
+    std::cerr << prec->name << ": Invalid link type for INP/OUT field: "
+              << pamaplinkType[ pconf->ioLink->type ].strvalue
+              << std::endl;
+    return false;
+  }
+
+  std::istringstream ss( pconf->ioLink->value.instio.string );
+  std::string option;
+  while( std::getline( ss, option, ' ' ) ) options.push_back( option );
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Check the property of an item against the record configuration
+//! @param [in]  prec      Address of the record
+//! @param [in]  pconf     Address of record configuration
+//! @param [in]  object    Object name of the item
+//! @param [in]  isegItem  Property of the item from isegHAL
+//! @param [in]  type      Data type required by the record
+//! @return      false if the item cannot be used by this record, otherwise true
+//------------------------------------------------------------------------------
+static bool checkItemProperty( dbCommon* prec, const devIsegHal_rec_t* pconf, const char* object,
+                               IsegItemProperty const& isegItem, const char* type ) {
+  if( strcmp( isegItem.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) {
+    fprintf( stderr, "\033[31;1m%s: Error while reading item property '%s' (Q: %s)\033[0m\n",
+             prec->name, object, isegItem.quality );
+    return false;
+  }
+
+  // "Vorsicht ist die Mutter der Porzelankiste",
+  // or "Better safe than sorry"
+  for ( size_t i = 0; i < strlen( pconf->access ); ++i ) {
+    if ( NULL == strchr( isegItem.access, pconf->access[i] ) ) {
+      fprintf( stderr, "\033[31;1m%s: Access rights of item '%s' don't match: %s|%s!\033[0m\n",
+               prec->name, isegItem.object, pconf->access, isegItem.access );
+      return false;
+    }
+  }
+  if ( strncmp( isegItem.type, type, strlen( type ) ) != 0 ) {
+    fprintf( stderr, "\033[31;1m%s: DataType '%s' of '%s' not supported by this record!\033[0m\n",
+             prec->name, isegItem.type, isegItem.object );
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Read the initial value of an item from isegHAL
+//! @param [in]  prec   Address of the record
+//! @param [in]  pinfo  Address of the private data, receives value and timestamp
+//!
+//! Errors are only reported, the value is then marked invalid.
+//! If the item of an input record is found in the snapshot file, its value
+//! is taken from there and flagged stale. Output records always read the
+//! current value, otherwise a write could send the old value to the
+//! hardware before the item was read from isegHAL.
+//! If the initialization of the interface is deferred, the value is left
+//! invalid and flagged stale, it is fetched by the polling thread once the
+//! IOC is running.
+//------------------------------------------------------------------------------
+static void readInitialValue( dbCommon* prec, devIsegHal_info_t* pinfo ) {
+  pinfo->stale = ( !pinfo->output
+                   && isegHalSnapshot::instance().value( pinfo->interface, pinfo->object, pinfo->value.str, pinfo->time ) );
+  if( pinfo->stale ) {
+    devIsegHalParseValue( &pinfo->value );
+    return;
+  }
+  if( pollerOf( pinfo )->deferInit() ) {
+    pinfo->stale = true;
+    pinfo->value.str[0] = '\0';
+    pinfo->value.valid  = false;
+    epicsTimeGetCurrent( &pinfo->time );
+    return;
+  }
+
+  IsegItem item = iseg_getItem( pinfo->interface, pinfo->object );
+  if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) {
+    fprintf( stderr, "\033[31;1m%s: Error while reading value '%s' from interface '%s': '%s' (Q: %s)\033[0m\n",
+             prec->name, item.object, pinfo->interface, item.value, item.quality );
   }
-  if ( stop->tv_nsec - start_nsec > 1e9 ) {
-    long nSeconds = ( stop->tv_nsec - start_nsec) / 1e9;
-    start_nsec += 1e9 * nSeconds;
-    start_sec  -= nSeconds;
+  if( devIsegHalParseTime( item.timeStampLastChanged, &pinfo->time ) != OK ) {
+    fprintf( stderr, "\033[31;1m%s: Error parsing timestamp for '%s': %s\033[0m\n", prec->name, pinfo->object, item.timeStampLastChanged );
+    epicsTimeGetCurrent( &pinfo->time );
   }
+  memcpy( pinfo->value.str, item.value, VALUE_SIZE );
+  devIsegHalParseValue( &pinfo->value );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Extract the bits of a record from a register value
+//! @param [in]  pinfo  Address of the record's private data
+//! @param [in]  pval   Address of the parsed value of the register
+//------------------------------------------------------------------------------
+static inline void applyMask( const devIsegHal_info_t* pinfo, devIsegHal_value_t* pval ) {
+  if( pinfo->mask ) pval->uval = ( pval->uval & pinfo->mask ) >> pinfo->shift;
+}
 
-  double	nSeconds = stop->tv_sec  - start_sec;
-  double	nNSec	 = stop->tv_nsec - start_nsec;
+//------------------------------------------------------------------------------
+//! @brief       Hook into the initialization of the IOC
+//! @param [in]  state  State of the initialization
+//!
+//! The initial values of deferred and snapshot records are fetched once
+//! the IOC is running, since their records cannot be scanned before.
+//------------------------------------------------------------------------------
+static void devIsegHalInitHook( initHookState state ) {
+  if( initHookAfterIocRunning == state ) isegHalConnectionHandler::instance().fetchInitial();
+}
 
-  return nSeconds + ( nNSec / 1.0e9 );
+//------------------------------------------------------------------------------
+//! @brief       Split a list of raw broadcast frames
+//! @param [in]  frames  Frames, separated by spaces, commas or semicolons
+//! @return      List of frames
+//------------------------------------------------------------------------------
+static std::vector< std::string > splitFrames( const char* frames ) {
+  std::vector< std::string > list;
+  std::string all( frames ? frames : "" );
+  size_t begin = all.find_first_not_of( " \t,;" );
+  while( begin != std::string::npos ) {
+    size_t end = all.find_first_of( " \t,;", begin );
+    list.push_back( all.substr( begin, end - begin ) );
+    begin = all.find_first_not_of( " \t,;", end );
+  }
+  return list;
 }
 
 static std::ostream& operator<<( std::ostream& ost, const IsegResult& result ) {
@@ -118,6 +350,9 @@ isegHalConnectionHandler::~isegHalConnectionHandler() {
   	}
   }
   _interfaces.clear();
+
+  std::map< std::string, isegHalThread* >::iterator pit = _pollers.begin();
+  for( ; pit != _pollers.end(); ++pit ) pit->second->disable();
 }
 
 //------------------------------------------------------------------------------
@@ -138,13 +373,26 @@ isegHalConnectionHandler& isegHalConnectionHandler::instance() {
 //! @brief       Connect to new interface
 //! @param [in]  name        deviseg internal name of the interface handle
 //! @param [in]  interface   name of the hardware interface
+//! @param [in]  timeout     maximum time in seconds to wait until isegHAL is ready,
+//!                          0 for the default of 30 s
 //! @return      true if interface is already connected or if successfully connected
+//!
+//! The name is marked as connecting before calling iseg_connect, so a
+//! concurrent connect of the same name waits for the first one and
+//! returns its result instead of connecting again.
 //------------------------------------------------------------------------------
-bool isegHalConnectionHandler::connect( std::string const& name, std::string const& interface ) {
+bool isegHalConnectionHandler::connect( std::string const& name, std::string const& interface, double timeout ) {
 
-  std::vector< std::string >::iterator it;
-  it = std::find( _interfaces.begin(), _interfaces.end(), name );
-  if( it != _interfaces.end() ) return true;
+  _lock.lock();
+  while( std::find( _connecting.begin(), _connecting.end(), name ) != _connecting.end() ) {
+    _lock.unlock();
+    epicsThreadSleep( readyProbe );
+    _lock.lock();
+  }
+  bool found = ( std::find( _interfaces.begin(), _interfaces.end(), name ) != _interfaces.end() );
+  if( !found ) _connecting.push_back( name );
+  _lock.unlock();
+  if( found ) return true;
 
   //  std::cout << "Trying to connect to '" << interface << "'" << std::endl;
 
@@ -154,16 +402,156 @@ bool isegHalConnectionHandler::connect( std::string const& name, std::string con
               << "  Result: " << status
               << ", Error: " << strerror( errno ) << "(" << errno << ")\033[0m"
               << std::endl;
+    _lock.lock();
+    _connecting.erase( std::find( _connecting.begin(), _connecting.end(), name ) );
+    _lock.unlock();
     return false;
   }
-  // iseg HAL starts collecting data from hardware after connect.
-  // wait 5 secs to let all values 'initialize'
-  sleep( 5 ); 
+  // iseg HAL starts collecting data from hardware after connect,
+  // wait until all values are 'initialized'
+  if( timeout <= 0. ) timeout = connectTimeout;
+  double ready = waitReady( name, timeout );
+  if( ready < 0. ) {
+    std::cerr << "\033[31;1misegHAL interface '" << interface << "' not ready after "
+              << timeout << " s, continuing anyway\033[0m" << std::endl;
+  }
 
+  poller( name );
+  _lock.lock();
+  _readyTime[name] = ready;
   _interfaces.push_back( name );
+  _connecting.erase( std::find( _connecting.begin(), _connecting.end(), name ) );
+  _lock.unlock();
   return true;
 }
 
+//------------------------------------------------------------------------------
+//! @brief       Connect to several interfaces concurrently
+//! @param [in]  interfaces  pairs of deviseg internal name and hardware interface
+//! @param [in]  timeout     maximum time in seconds to wait until isegHAL is ready,
+//!                          0 for the default of 30 s
+//! @return      true if all interfaces are connected
+//!
+//! Each interface is connected by its own thread, so the IOC waits only
+//! once for isegHAL to collect the data of all interfaces.
+//! The time needed for each interface is printed.
+//! Nothing is connected if a name is given more than once.
+//------------------------------------------------------------------------------
+bool isegHalConnectionHandler::connectAll( std::vector< std::pair< std::string, std::string > > const& interfaces,
+                                           double timeout ) {
+  std::vector< std::pair< std::string, std::string > >::const_iterator it = interfaces.begin();
+  for( ; it != interfaces.end(); ++it ) {
+    std::vector< std::pair< std::string, std::string > >::const_iterator dit = it + 1;
+    for( ; dit != interfaces.end(); ++dit ) {
+      if( dit->first != it->first ) continue;
+      std::cerr << "\033[31;1mInterface name '" << it->first << "' given for '" << it->second
+                << "' and '" << dit->second << "', nothing connected\033[0m" << std::endl;
+      return false;
+    }
+  }
+
+  epicsUInt64 start = epicsMonotonicGet();
+  std::vector< isegHalConnector* > connectors;
+  it = interfaces.begin();
+  for( ; it != interfaces.end(); ++it ) {
+    isegHalConnector* pconnector = new isegHalConnector( it->first, it->second, timeout );
+    pconnector->thread.start();
+    connectors.push_back( pconnector );
+  }
+
+  bool success = true;
+  std::vector< isegHalConnector* >::iterator cit = connectors.begin();
+  for( ; cit != connectors.end(); ++cit ) {
+    (*cit)->done.wait();
+    printf( "isegHAL interface '%s' (%s): %s after %.3lf s\n", (*cit)->name.c_str(), (*cit)->interface.c_str(),
+            (*cit)->connected ? "connected" : "\033[31;1mnot connected\033[0m", (*cit)->duration );
+    success &= (*cit)->connected;
+    delete *cit;
+  }
+  printf( "Connected %lu interfaces in %.3lf s\n", (unsigned long)interfaces.size(),
+          ( epicsMonotonicGet() - start ) * 1e-9 );
+  return success;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Wait until isegHAL has collected the data of an interface
+//! @param [in]  name     deviseg internal name of the interface handle
+//! @param [in]  timeout  maximum time to wait in seconds
+//! @return      time in seconds until isegHAL was ready, negative on timeout
+//!
+//! isegHAL is ready once the modules of all lines are listed with quality
+//! OK and afterwards a complete collection cycle has passed, i.e. the
+//! CycleCounter advanced.
+//! If the module lists are not complete within a few seconds, isegHAL is
+//! considered ready once the CycleCounter advanced twice.
+//------------------------------------------------------------------------------
+double isegHalConnectionHandler::waitReady( std::string const& name, double timeout ) {
+  epicsUInt64 start = epicsMonotonicGet();
+  bool listed = false;
+  epicsUInt32 listedCycle = 0;
+  bool counted = false;
+  epicsUInt32 firstCycle = 0;
+
+  while( true ) {
+    double elapsed = ( epicsMonotonicGet() - start ) * 1e-9;
+
+    devIsegHal_value_t value;
+    value.type = devIsegHalParseType( "UI4" );
+    IsegItem item = iseg_getItem( name.c_str(), "CycleCounter" );
+    memcpy( value.str, item.value, VALUE_SIZE );
+    devIsegHalParseValue( &value );
+    bool cycle = ( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) == 0 && value.valid );
+
+    if( cycle && !counted ) {
+      counted    = true;
+      firstCycle = value.uval;
+    }
+    if( cycle && !listed ) {
+      listed = modulesListed( name );
+      // a complete cycle has to pass after the modules are known
+      listedCycle = value.uval;
+      if( !listed && elapsed >= listTimeout && value.uval - firstCycle >= 2 ) return elapsed;
+    } else if( cycle && value.uval != listedCycle ) {
+      return elapsed;
+    }
+
+    if( elapsed >= timeout ) return -1.;
+    epicsThreadSleep( readyProbe );
+  }
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Check if isegHAL has listed all modules of an interface
+//! @param [in]  name     deviseg internal name of the interface handle
+//! @return      true if the modules of all lines are listed, otherwise false
+//!
+//! The lines are probed until the module numbers of the lines add up to
+//! the module number of the system. The module list of each line with
+//! modules must have quality OK, lines without modules are skipped.
+//------------------------------------------------------------------------------
+bool isegHalConnectionHandler::modulesListed( std::string const& name ) {
+  IsegItem item = iseg_getItem( name.c_str(), "ModuleNumber" );
+  if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) return false;
+  unsigned long modules = strtoul( item.value, NULL, 10 );
+
+  unsigned long listed = 0;
+  for( unsigned line = 0; listed < modules && line < maxLines; ++line ) {
+    std::ostringstream os;
+    os << line << ".ModuleNumber";
+    item = iseg_getItem( name.c_str(), os.str().c_str() );
+    if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) continue;
+    unsigned long lineModules = strtoul( item.value, NULL, 10 );
+    if( 0 == lineModules ) continue;
+
+    os.str( "" );
+    os << line << ".ModuleList";
+    item = iseg_getItem( name.c_str(), os.str().c_str() );
+    if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) return false;
+    listed += lineModules;
+  }
+  return listed >= modules;
+}
+
 //------------------------------------------------------------------------------
 //! @brief       Check if an interface is connected
 //! @param [in]  name    deviseg internal name of the interface handle
@@ -171,10 +559,12 @@ bool isegHalConnectionHandler::connect( std::string const& name, std::string con
 bool isegHalConnectionHandler::connected( std::string const& name ) {
   if( name.compare( "AUTO" ) == 0 ) return true;
 
+  _lock.lock();
   std::vector< std::string >::iterator it;
   it = std::find( _interfaces.begin(), _interfaces.end(), name );
-  if( it != _interfaces.end() ) return true;
-  return false;
+  bool found = ( it != _interfaces.end() );
+  _lock.unlock();
+  return found;
 }
 
 //------------------------------------------------------------------------------
@@ -182,6 +572,7 @@ bool isegHalConnectionHandler::connected( std::string const& name ) {
 //! @param [in]  name    deviseg internal name of the interface handle
 //------------------------------------------------------------------------------
 void isegHalConnectionHandler::disconnect( std::string const& name ) {
+  _lock.lock();
   std::vector< std::string >::iterator it;
   it = std::find( _interfaces.begin(), _interfaces.end(), name );
 
@@ -191,10 +582,138 @@ void isegHalConnectionHandler::disconnect( std::string const& name ) {
       std::cerr << "\033[31;1m Cannot disconnect from isegHAL interface '"
                 << name << "'.\033[0m"
                 << std::endl;
+      _lock.unlock();
   		return;
   	}
     _interfaces.erase( it );
   }
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get polling thread of an interface
+//! @param [in]  name    deviseg internal name of the interface handle
+//! @return      Address of the polling thread
+//!
+//! Each interface has its own polling thread. If no thread exists yet
+//! for this interface, it is created. Threads created after iocInit
+//! are started immediately.
+//------------------------------------------------------------------------------
+isegHalThread* isegHalConnectionHandler::poller( std::string const& name ) {
+  _lock.lock();
+  std::map< std::string, isegHalThread* >::iterator it = _pollers.find( name );
+  if( it != _pollers.end() ) {
+    _lock.unlock();
+    return it->second;
+  }
+
+  isegHalThread* pthread = new isegHalThread( name );
+  pthread->setLane( _pollers.size() );
+  _pollers.insert( std::make_pair( name, pthread ) );
+  if( _pollersStarted ) {
+    pthread->writer.thread.start();
+    pthread->thread.start();
+  }
+  _lock.unlock();
+  return pthread;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Start the polling threads of all interfaces
+//------------------------------------------------------------------------------
+void isegHalConnectionHandler::startPollers() {
+  _lock.lock();
+  if( _pollersStarted ) {
+    _lock.unlock();
+    return;
+  }
+  _pollersStarted = true;
+
+  // workers have to run before the first update is dispatched
+  isegHalWorkerPool::instance().start();
+
+  std::map< std::string, isegHalThread* >::iterator it = _pollers.begin();
+  for( ; it != _pollers.end(); ++it ) {
+    it->second->writer.thread.start();
+    it->second->thread.start();
+  }
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Fetch the initial values of the records of all interfaces
+//!
+//! Called once the IOC is running, see devIsegHalInitHook().
+//------------------------------------------------------------------------------
+void isegHalConnectionHandler::fetchInitial() {
+  _lock.lock();
+  std::map< std::string, isegHalThread* >::iterator it = _pollers.begin();
+  for( ; it != _pollers.end(); ++it ) it->second->requestFetch();
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       C'tor of isegHalConnector
+//! @param [in]  name        deviseg internal name of the interface handle
+//! @param [in]  interface   name of the hardware interface
+//! @param [in]  timeout     maximum time in seconds to wait until isegHAL is ready
+//------------------------------------------------------------------------------
+isegHalConnector::isegHalConnector( std::string const& name, std::string const& interface, double timeout )
+  : thread( *this, ( "isegHALconnect:" + name ).c_str(), epicsThreadGetStackSize( epicsThreadStackSmall ), 50 ),
+    name( name ),
+    interface( interface ),
+    timeout( timeout ),
+    connected( false ),
+    duration( 0. )
+{}
+
+//------------------------------------------------------------------------------
+//! @brief       Run operation of the connecting thread
+//------------------------------------------------------------------------------
+void isegHalConnector::run() {
+  epicsUInt64 start = epicsMonotonicGet();
+  connected = isegHalConnectionHandler::instance().connect( name, interface, timeout );
+  duration  = ( epicsMonotonicGet() - start ) * 1e-9;
+  done.signal();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Print report of all interfaces and their polling threads
+//! @param [in]  level   Level of detail
+//------------------------------------------------------------------------------
+void isegHalConnectionHandler::report( int level ) {
+  // connect threads may add interfaces meanwhile, report a copy
+  _lock.lock();
+  std::map< std::string, isegHalThread* > pollers( _pollers );
+  std::map< std::string, double > readyTime( _readyTime );
+  _lock.unlock();
+
+  std::map< std::string, isegHalThread* >::const_iterator it = pollers.begin();
+  for( ; it != pollers.end(); ++it ) {
+    printf( "isegHAL interface '%s' (%s)\n", it->first.c_str(),
+            connected( it->first ) ? "connected" : "not connected" );
+    std::map< std::string, double >::const_iterator rit = readyTime.find( it->first );
+    if( rit != readyTime.end() && rit->second >= 0. ) {
+      printf( "  ready %.3lf s after connect\n", rit->second );
+    } else if( rit != readyTime.end() ) {
+      printf( "  not ready within the connect timeout\n" );
+    }
+    if( level > 0 ) it->second->report( level );
+  }
+  isegHalWorkerPool::instance().report( level );
+  isegHalPropertyCache::instance().report( level );
+  isegHalSnapshot::instance().report( level );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the last values of the items of all interfaces
+//! @param [out] values  Values for the snapshot file
+//------------------------------------------------------------------------------
+void isegHalConnectionHandler::snapshot( std::vector< isegHalSnapshotValue >& values ) const {
+  _lock.lock();
+  std::map< std::string, isegHalThread* >::const_iterator it = _pollers.begin();
+  for( ; it != _pollers.end(); ++it ) it->second->snapshot( values );
+  _lock.unlock();
 }
 
 
@@ -206,22 +725,16 @@ void isegHalConnectionHandler::disconnect( std::string const& name ) {
 //------------------------------------------------------------------------------
 long devIsegHalInit( int after ) {
 
-  if ( 0 == after ) { // before records have been initialized
-    static bool firstRunBefore = true;
-    if ( !firstRunBefore ) return 0;
-    firstRunBefore = false;
-
-    // create polling thread
-    myIsegHalThread = new isegHalThread();
-
-  } else {
-
+  if ( 0 != after ) { // after records have been initialized
     static bool firstRunAfter = true;
     if ( !firstRunAfter ) return 0;
     firstRunAfter = false;
 
-    // start thread
-    myIsegHalThread->thread.start();
+    // start one polling thread per interface
+    isegHalConnectionHandler::instance().startPollers();
+
+    // records are initialized, the snapshot file is no longer needed
+    isegHalSnapshot::instance().release();
   }
 
   return OK;
@@ -238,21 +751,12 @@ long devIsegHalInitRecord( dbCommon *prec, const devIsegHal_rec_t *pconf ) {
   devIsegHal_dset_t *pdset = (devIsegHal_dset_t *)prec->dset;
   long status = OK;
 
-  if( INST_IO != pconf->ioLink->type ) {
-    std::cerr << prec->name << ": Invalid link type for INP/OUT field: "
-              << pamaplinkType[ pconf->ioLink->type ].strvalue
-              << std::endl;
-    return ERROR;
-  }
-
   std::vector< std::string > options;
-  std::istringstream ss( pconf->ioLink->value.instio.string );
-  std::string option;
-  while( std::getline( ss, option, ' ' ) ) options.push_back( option );
+  if( !splitLink( prec, pconf, options ) ) return ERROR;
 
-  if( options.size() != 2 ) {
-    std::cerr << prec->name << ": Invalid INP/OUT field: " << ss.str() << "\n"
-              << "    Syntax is \"@<isegItem> <Interface>\"" << std::endl;
+  if( options.size() != 2 && options.size() != 3 ) {
+    std::cerr << prec->name << ": Invalid INP/OUT field: " << pconf->ioLink->value.instio.string << "\n"
+              << "    Syntax is \"@<isegItem> <Interface> [<PollClass>]\"" << std::endl;
     return ERROR;
   }
 
@@ -263,59 +767,89 @@ long devIsegHalInitRecord( dbCommon *prec, const devIsegHal_rec_t *pconf ) {
     return ERROR;
   }
 
-  IsegItemProperty isegItem = iseg_getItemProperty( options.at(1).c_str(), options.at(0).c_str() );
-  if( strcmp( isegItem.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) {
-    fprintf( stderr, "\033[31;1m%s: Error while reading item property '%s' (Q: %s)\033[0m\n",
-             prec->name, options.at(0).c_str(), isegItem.quality );
-    return ERROR; 
-  }
-
-  // "Vorsicht ist die Mutter der Porzelankiste",
-  // or "Better safe than sorry"
-  for ( size_t i = 0; i < strlen( pconf->access ); ++i ) {
-    if ( NULL == strchr( isegItem.access, pconf->access[i] ) ) {
-      fprintf( stderr, "\033[31;1m%s: Access rights of item '%s' don't match: %s|%s!\033[0m\n",
-               prec->name, isegItem.object, pconf->access, isegItem.access );
+  /// Poll class from INP/OUT field or info tag
+  isegHalPollClass* pclass = recordPollClass( prec, options );
+  if( !pclass ) return ERROR;
+
+  /// A bit "ITEM:N" can be used as view of the register ITEM, which is then
+  /// shared with the other bits and mbbiDirect/mbboDirect records of ITEM
+  std::string object = options.at(0);
+  const char* type = pconf->type;
+  epicsUInt32 mask = pconf->mask;
+  unsigned short shift = 0;
+  size_t colon = object.rfind( ':' );
+  if( colon != std::string::npos && getInfoTag( prec, "isegBitView" ) == "YES" ) {
+    unsigned bit = 0;
+    if( sscanf( object.c_str() + colon + 1, "%u", &bit ) != 1 || bit > 31 ) {
+      std::cerr << prec->name << ": Invalid bit in '" << object << "'" << std::endl;
       return ERROR;
     }
+    object.erase( colon );
+    type  = "UI";
+    mask  = 1u << bit;
+    shift = bit;
   }
-  if ( strncmp( isegItem.type, pconf->type, strlen( pconf->type ) ) != 0 ) {
-    fprintf( stderr, "\033[31;1m%s: DataType '%s' of '%s' not supported by this record!\033[0m\n",
-             prec->name, isegItem.type, isegItem.object );
-    return ERROR; 
-  }
+
+  IsegItemProperty isegItem = isegHalPropertyCache::instance().get( options.at(1), object );
+  if( !checkItemProperty( prec, pconf, object.c_str(), isegItem, type ) ) return ERROR;
 
   devIsegHal_info_t *pinfo = new devIsegHal_info_t;
   memcpy( pinfo->object, isegItem.object, FULLY_QUALIFIED_OBJECT_SIZE );
   strncpy( pinfo->interface, options.at(1).c_str(), 20 );
   memcpy( pinfo->unit,   isegItem.unit,   UNIT_SIZE );
-  pinfo->pcallback = NULL;  // just to be sure
+  pinfo->value.type = devIsegHalParseType( isegItem.type );
+  pinfo->prec = prec;
+  pinfo->output = pconf->registerCallback;
+  pinfo->readback = 0;
+  pinfo->inReadback = false;
+  pinfo->pending = false;
+  callbackSetCallback( readbackCallback, &pinfo->readbackCallback );
+  callbackSetUser( pinfo, &pinfo->readbackCallback );
+  pinfo->writeStatus = OK;
+  pinfo->windowError = 0;
+  pinfo->writeErrors = 0;
+  pinfo->ppoller = isegHalConnectionHandler::instance().poller( options.at(1) );
+  pinfo->pitem = NULL;
+  pinfo->pollIndex = -1;
+  pinfo->parray = NULL;
+  pinfo->pparent = NULL;
+  pinfo->pemergency = NULL;
+  pinfo->mask = mask;
+  pinfo->shift = shift;
+
+  pinfo->pclass = pclass;
 
   /// Get initial value from HAL
-  IsegItem item = iseg_getItem( pinfo->interface, pinfo->object );
-  if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) {
-    fprintf( stderr, "\033[31;1m%s: Error while reading value '%s' from interface '%s': '%s' (Q: %s)\033[0m\n",
-             prec->name, item.object, pinfo->interface, item.value, item.quality );
-  }
-  epicsUInt32 seconds = 0;
-  epicsUInt32 microsecs = 0;
-  if( sscanf( item.timeStampLastChanged, "%u.%u", &seconds, &microsecs ) != 2 ) {
-    fprintf( stderr, "\033[31;1m%s: Error parsing timestamp for '%s': %s\033[0m\n", prec->name, pinfo->object, item.timeStampLastChanged );
-  }
-  pinfo->time.secPastEpoch = seconds - POSIX_TIME_AT_EPICS_EPOCH;
-  pinfo->time.nsec = microsecs * 100000;
-  status = pdset->conv_val_str( prec, item.value );
-  if( ERROR == status ) {
-    fprintf( stderr, "\033[31;1m%s: Error parsing value for '%s': %s\033[0m\n", prec->name, pinfo->object, item.value );
+  readInitialValue( prec, pinfo );
+  bool deferred = ( pinfo->stale && !pinfo->value.valid );
+  if( !deferred ) {
+    devIsegHal_value_t value = pinfo->value;
+    applyMask( pinfo, &value );
+    status = pdset->conv_val_str( prec, &value );
+    if( ERROR == status ) {
+      fprintf( stderr, "\033[31;1m%s: Error parsing value for '%s': %s\033[0m\n", prec->name, pinfo->object, pinfo->value.str );
+    }
   }
   if( -2 == prec->tse ) prec->time = pinfo->time;
+  if( deferred ) {
+    // value is fetched after iocInit, cleared by the first update from isegHAL
+    prec->stat = UDF_ALARM;
+    prec->sevr = INVALID_ALARM;
+  } else if( pinfo->stale ) {
+    // value from the snapshot file, cleared by the first update from isegHAL
+    prec->stat = TIMEOUT_ALARM;
+    prec->sevr = MINOR_ALARM;
+  }
 
   /// I/O Intr handling
-  scanIoInit( &pinfo->ioscanpvt );
-  if( pconf->registerCallback ) myIsegHalThread->registerInterrupt( prec, pinfo );
+  pinfo->pitem = pollerOf( pinfo )->item( pinfo );
+  pinfo->ioscanpvt = static_cast< isegHalItem* >( pinfo->pitem )->pgroup->ioscanpvt;
+  if( pconf->registerCallback ) pollerOf( pinfo )->registerInterrupt( prec, pinfo );
 
   prec->dpvt = pinfo;
-  prec->udf  = (epicsUInt8)false;
+  // output records keep UDF unset, otherwise IVOA could suppress the
+  // processing which sets their first readback value
+  prec->udf  = (epicsUInt8)( deferred && !pconf->registerCallback );
 
   return OK;
 }
@@ -328,32 +862,25 @@ long devIsegHalInitRecord( dbCommon *prec, const devIsegHal_rec_t *pconf ) {
 //------------------------------------------------------------------------------
 long devIsegHalGlobalSwitchInit( dbCommon *prec, const devIsegHal_rec_t *pconf ) {
 
-  if( INST_IO != pconf->ioLink->type ) {
-    std::cerr << prec->name << ": Invalid link type for INP/OUT field: "
-              << pamaplinkType[ pconf->ioLink->type ].strvalue
-              << std::endl;
-    return ERROR;
-  }
-
   std::vector< std::string > options;
-  std::istringstream ss( pconf->ioLink->value.instio.string );
-  std::string option;
-  while( std::getline( ss, option, ' ' ) ) options.push_back( option );
+  if( !splitLink( prec, pconf, options ) ) return ERROR;
 
   if( options.size() != 2 ) {
-    std::cerr << prec->name << ": Invalid INP/OUT field: " << ss.str() << "\n"
-              << "    Syntax is \"@<{OnOff|Emergency}> <Interface>\"" << std::endl;
+    std::cerr << prec->name << ": Invalid INP/OUT field: " << pconf->ioLink->value.instio.string << "\n"
+              << "    Syntax is \"@<{OnOff|Emergency|Batch}> <Interface>\"" << std::endl;
     return ERROR;
   }
   
-  bool emergency;
+  char type;
   if( "OnOff" == options[0] ) {
-    emergency = false;
+    type = 'O';
   } else if( "Emergency" == options[0] ) {
-    emergency = true;
+    type = 'E';
+  } else if( "Batch" == options[0] ) {
+    type = 'B';
   } else {
-    std::cerr << prec->name << ": Invalid INP/OUT field: " << ss.str() << "\n"
-              << "    Syntax is \"@<{OnOff|Emergency}> <Interface>\"" << std::endl;
+    std::cerr << prec->name << ": Invalid INP/OUT field: " << pconf->ioLink->value.instio.string << "\n"
+              << "    Syntax is \"@<{OnOff|Emergency|Batch}> <Interface>\"" << std::endl;
     return ERROR;
   }
   
@@ -366,12 +893,29 @@ long devIsegHalGlobalSwitchInit( dbCommon *prec, const devIsegHal_rec_t *pconf )
 
   devIsegHal_info_t *pinfo = new devIsegHal_info_t;
   memset( pinfo->object, 0, FULLY_QUALIFIED_OBJECT_SIZE );
-  pinfo->object[0] = emergency ? 'E' : 'O'; // Abuse field for iseg item to store 'O' for normal on/off and 'E' for emergency off
+  pinfo->object[0] = type; // Abuse field for iseg item to store 'O' for normal on/off, 'E' for emergency off and 'B' for batches
   strncpy( pinfo->interface, options.at(1).c_str(), 20 );
   memset( pinfo->unit, 0, UNIT_SIZE );
-  pinfo->pcallback = NULL;  // just to be sure
-
-  if( pconf->registerCallback ) myIsegHalThread->registerInterrupt( prec, pinfo );
+  pinfo->prec = prec;
+  pinfo->output = false;
+  pinfo->readback = 0;
+  pinfo->inReadback = false;
+  pinfo->pending = false;
+  pinfo->writeStatus = OK;
+  pinfo->windowError = 0;
+  pinfo->writeErrors = 0;
+  pinfo->ppoller = isegHalConnectionHandler::instance().poller( options.at(1) );
+  pinfo->pclass = NULL;
+  pinfo->pitem = NULL;
+  pinfo->pollIndex = -1;
+  pinfo->parray = NULL;
+  pinfo->pparent = NULL;
+  pinfo->pemergency = NULL;
+  pinfo->mask = 0;
+  pinfo->shift = 0;
+  pinfo->stale = false;
+
+  if( pconf->registerCallback ) pollerOf( pinfo )->registerInterrupt( prec, pinfo );
 
   prec->dpvt = pinfo;
 
@@ -379,34 +923,92 @@ long devIsegHalGlobalSwitchInit( dbCommon *prec, const devIsegHal_rec_t *pconf )
 }
 
 //------------------------------------------------------------------------------
-//! @brief       Get I/O Intr Information of record
-//! @param [in]  cmd   0 if record is placed in, 1 if taken out of an I/O scan list 
-//! @param [in]  prec  Address of record calling this funciton
-//! @param [out] ppvt  Address of IOSCANPVT structure
-//! @return      ERROR in case of an error, otherwise OK
+//! @brief       Initialization of records reading statistics of a polling thread
+//! @param [in]  prec       Address of the record calling this function
+//! @param [in]  pconf      Address of record configuration
+//! @return      In case of error return -1, otherwise return 0
 //------------------------------------------------------------------------------
-long devIsegHalGetIoIntInfo( int cmd, dbCommon *prec, IOSCANPVT *ppvt ) {
-  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
-  *ppvt = pinfo->ioscanpvt;
-  if ( 0 == cmd ) {
-    myIsegHalThread->registerInterrupt( prec, pinfo );
-  } else {
-    myIsegHalThread->cancelInterrupt( pinfo );
-  }
-  return OK;
-}
+long devIsegHalStatInit( dbCommon *prec, const devIsegHal_rec_t *pconf ) {
 
-//------------------------------------------------------------------------------
-//! @brief       Common read function of the records
-//! @param [in]  prec  Address of record calling this funciton
-//! @return      ERROR in case of an error, otherwise OK
-//------------------------------------------------------------------------------
-long devIsegHalRead( dbCommon *prec ) {
-  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
-  devIsegHal_dset_t *pdset = (devIsegHal_dset_t *)prec->dset;
-  long status = OK;
+  std::vector< std::string > options;
+  if( !splitLink( prec, pconf, options ) ) return ERROR;
 
-  if( !prec->pact ) {
+  if( options.size() != 2 ) {
+    std::cerr << prec->name << ": Invalid INP/OUT field: " << pconf->ioLink->value.instio.string << "\n"
+              << "    Syntax is \"@<Statistic> <Interface>\"" << std::endl;
+    return ERROR;
+  }
+
+  // Test if interface is connected to isegHAL server
+  if( !isegHalConnectionHandler::instance().connected( options.at(1) ) ) {
+    std::cerr << "\033[31;1m" << "isegHal interface " << options.at(1) << " not connected!"
+              << "\033[0m" << std::endl;
+    return ERROR;
+  }
+
+  isegHalThread* pthread = isegHalConnectionHandler::instance().poller( options.at(1) );
+  double value = 0.;
+  if( !pthread->statistic( options.at(0), value ) ) {
+    std::cerr << prec->name << ": Unknown statistic '" << options.at(0) << "'" << std::endl;
+    return ERROR;
+  }
+
+  devIsegHal_info_t *pinfo = new devIsegHal_info_t;
+  memset( pinfo, 0, sizeof( devIsegHal_info_t ) );
+  strncpy( pinfo->object, options.at(0).c_str(), FULLY_QUALIFIED_OBJECT_SIZE - 1 );
+  strncpy( pinfo->interface, options.at(1).c_str(), 20 );
+  pinfo->ppoller = pthread;
+  pinfo->pollIndex = -1;
+
+  prec->dpvt = pinfo;
+
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Read statistics of a polling thread
+//! @param [in]  prec    Address of record calling this funciton
+//! @param [out] pvalue  Address of the value
+//! @return      ERROR in case of an error, otherwise OK
+//------------------------------------------------------------------------------
+long devIsegHalStatRead( dbCommon *prec, epicsFloat64 *pvalue ) {
+  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
+  if( !pinfo || !pollerOf( pinfo )->statistic( pinfo->object, *pvalue ) ) {
+    recGblSetSevr( prec, READ_ALARM, INVALID_ALARM ); // Set record to READ_ALARM
+    return ERROR;
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get I/O Intr Information of record
+//! @param [in]  cmd   0 if record is placed in, 1 if taken out of an I/O scan list 
+//! @param [in]  prec  Address of record calling this funciton
+//! @param [out] ppvt  Address of IOSCANPVT structure
+//! @return      ERROR in case of an error, otherwise OK
+//------------------------------------------------------------------------------
+long devIsegHalGetIoIntInfo( int cmd, dbCommon *prec, IOSCANPVT *ppvt ) {
+  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
+  *ppvt = pinfo->ioscanpvt;
+  if ( 0 == cmd ) {
+    pollerOf( pinfo )->registerInterrupt( prec, pinfo );
+  } else {
+    pollerOf( pinfo )->cancelInterrupt( pinfo );
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Common read function of the records
+//! @param [in]  prec  Address of record calling this funciton
+//! @return      ERROR in case of an error, otherwise OK
+//------------------------------------------------------------------------------
+long devIsegHalRead( dbCommon *prec ) {
+  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
+  devIsegHal_dset_t *pdset = (devIsegHal_dset_t *)prec->dset;
+  long status = OK;
+
+  if( menuScanI_O_Intr != prec->scan ) {
     // record "normally" processed
     IsegItem item = iseg_getItem( pinfo->interface, pinfo->object );
     if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) {
@@ -416,25 +1018,19 @@ long devIsegHalRead( dbCommon *prec ) {
       return ERROR; 
     }
 
-    epicsUInt32 seconds = 0;
-    epicsUInt32 microsecs = 0;
-    if( sscanf( item.timeStampLastChanged, "%u.%u", &seconds, &microsecs ) != 2 ) {
+    if( devIsegHalParseTime( item.timeStampLastChanged, &pinfo->time ) != OK ) {
       fprintf( stderr, "\033[31;1m%s: Error parsing timestamp for '%s': %s\033[0m\n", prec->name, pinfo->object, item.timeStampLastChanged );
       recGblSetSevr( prec, READ_ALARM, INVALID_ALARM ); // Set record to READ_ALARM
       return ERROR; 
     }
-    pinfo->time.secPastEpoch = seconds - POSIX_TIME_AT_EPICS_EPOCH;
-    pinfo->time.nsec = microsecs * 100000;
 
 #ifdef CHECK_LAST_REFRESHED
     epicsTimeStamp lastRefreshed;
-    if( sscanf( item.timeStampLastRefreshed, "%u.%u", &lastRefreshed.secPastEpoch, &lastRefreshed.nsec ) != 2 ) {
+    if( devIsegHalParseTime( item.timeStampLastRefreshed, &lastRefreshed ) != OK ) {
       fprintf( stderr, "\033[31;1m%s: Error parsing timestamp for '%s': %s\033[0m\n", prec->name, pinfo->object, item.timeStampLastRefreshed );
       recGblSetSevr( prec, READ_ALARM, INVALID_ALARM ); // Set record to READ_ALARM
       return ERROR; 
     }
-    lastRefreshed.secPastEpoch -= POSIX_TIME_AT_EPICS_EPOCH;
-    lastRefreshed.nsec *= 100000;
     if( epicsTime::getCurrent() - epicsTime( lastRefreshed ) >= 30.0 ) {
       /// value is older then 30 seconds
       recGblSetSevr( prec, TIMEOUT_ALARM, INVALID_ALARM );
@@ -442,7 +1038,12 @@ long devIsegHalRead( dbCommon *prec ) {
     }
 #endif
 
-    status = pdset->conv_val_str( prec, item.value );
+    devIsegHal_value_t value;
+    value.type = pinfo->value.type;
+    memcpy( value.str, item.value, VALUE_SIZE );
+    devIsegHalParseValue( &value );
+    applyMask( pinfo, &value );
+    status = pdset->conv_val_str( prec, &value );
     if( ERROR == status ) {
       fprintf( stderr, "\033[31;1m%s: Error parsing value for '%s': %s\033[0m\n", prec->name, pinfo->object, item.value );
       recGblSetSevr( prec, READ_ALARM, INVALID_ALARM ); // Set record to READ_ALARM
@@ -450,11 +1051,12 @@ long devIsegHalRead( dbCommon *prec ) {
     }
 
   } else { 
-    // record forced processed by CALLBACK
-    status = pdset->conv_val_str( prec, pinfo->value );
-    prec->pact = (epicsUInt8)false;
+    // record processed by I/O Intr, use value from polling thread
+    static_cast< isegHalItem* >( pinfo->pitem )->slot.load( &pinfo->value, &pinfo->time );
+    applyMask( pinfo, &pinfo->value );
+    status = pdset->conv_val_str( prec, &pinfo->value );
     if( ERROR == status ) {
-      fprintf( stderr, "\033[31;1m%s: Error parsing value for '%s': %s\033[0m\n", prec->name, pinfo->object, pinfo->value );
+      fprintf( stderr, "\033[31;1m%s: Error parsing value for '%s': %s\033[0m\n", prec->name, pinfo->object, pinfo->value.str );
       recGblSetSevr( prec, READ_ALARM, INVALID_ALARM ); // Set record to READ_ALARM
       return ERROR;
     }
@@ -474,42 +1076,99 @@ long devIsegHalRead( dbCommon *prec ) {
 //! @brief       Common write function of the records
 //! @param [in]  prec   Address of record calling this function
 //! @return      ERROR in case of an error, otherwise OK
+//!
+//! The value is queued to the writer thread of the interface and the record
+//! stays active (PACT=1) until the writer has completed the write.
+//! The record is then processed again by a callback to set its alarm
+//! state and timestamp.
+//! If a write window is set for the interface, the record is completed
+//! immediately and only the last value put within the window is written.
+//! A failed write is then reported with WRITE_ALARM by the readback the
+//! writer requests, or by the next processing of the record.
+//! Nothing is written while the initial value of a deferred record has
+//! not been fetched yet.
 //------------------------------------------------------------------------------
 long devIsegHalWrite( dbCommon *prec ) {
   devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
   devIsegHal_dset_t *pdset = (devIsegHal_dset_t *)prec->dset;
 
   if( prec->pact ) {
-    long status = pdset->conv_val_str( prec, pinfo->value );
+    // completion of an asynchronous write, which supersedes
+    // readbacks requested while the write was in progress
+    epicsAtomicSetIntT( &pinfo->readback, 0 );
+    if( ERROR == pinfo->writeStatus ) {
+      recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM
+      return ERROR;
+    }
+    if( -2 == prec->tse ) {
+      epicsTimeGetCurrent( &pinfo->time );
+      prec->time = pinfo->time;
+    }
+    return OK;
+  }
+
+  // record processed by the dispatcher, any other processing writes
+  if( pinfo->inReadback ) {
+    // readback already discarded by a write, keep the record as it is
+    if( !epicsAtomicCmpAndSwapIntT( &pinfo->readback, 1, 0 ) ) return OK;
+    // use readback value from polling thread
+    // pact is set, so the conversion routine parses the readback value
+    static_cast< isegHalItem* >( pinfo->pitem )->slot.load( &pinfo->value, &pinfo->time );
+    applyMask( pinfo, &pinfo->value );
+    prec->pact = (epicsUInt8)true;
+    long status = pdset->conv_val_str( prec, &pinfo->value );
     if( -2 == prec->tse ) prec->time = pinfo->time;
     prec->pact = (epicsUInt8)false;
     prec->udf = (epicsUInt8)false;
+    if( windowWriteFailed( prec, pinfo ) ) return ERROR;
     return status;
   }
 
-  myIsegHalThread->disable();
+  // initial value not fetched yet, VAL is still the default of the database
+  if( pinfo->stale && !pinfo->value.valid ) {
+    fprintf( stderr, "\033[31;1m%s: Initial value of '%s' not read yet, not writing\033[0m\n", prec->name, pinfo->object );
+    recGblSetSevr( prec, UDF_ALARM, INVALID_ALARM ); // Set record to UDF_ALARM
+    return ERROR;
+  }
 
-  char value[VALUE_SIZE];
-  long status = pdset->conv_val_str( prec, value );
+  // a write supersedes a pending readback
+  epicsAtomicSetIntT( &pinfo->readback, 0 );
+
+  devIsegHal_value_t value;
+  value.type = pinfo->value.type;
+  long status = pdset->conv_val_str( prec, &value );
   if( ERROR == status ) {
     fprintf( stderr, "\033[31;1m%s: Error parsing value for '%s'\033[0m\n", prec->name, pinfo->object );
     recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM
     return ERROR;
   }
 
-  if( iseg_setItem( pinfo->interface, pinfo->object, value ) != ISEG_OK ) {
-    fprintf( stderr, "\033[31;1m%s: Error while writing value '%s': '%s'\033[0m\n",
-             prec->name, pinfo->object, value );
-    recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM 
-    return ERROR; 
+  isegHalWriter& writer = pollerOf( pinfo )->writer;
+  if( writer.window() > 0. ) {
+    // last value wins, a failed write is reported by the next processing
+    bool failed = windowWriteFailed( prec, pinfo );
+    if( !writer.post( pinfo, value.str ) ) {
+      fprintf( stderr, "\033[31;1m%s: Write queue of interface '%s' full, dropping value '%s'\033[0m\n",
+               prec->name, pinfo->interface, value.str );
+      recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM
+      return ERROR;
+    }
+    if( -2 == prec->tse ) {
+      epicsTimeGetCurrent( &pinfo->time );
+      prec->time = pinfo->time;
+    }
+    return failed ? ERROR : status;
   }
 
-  if( -2 == prec->tse ) {
-    epicsTimeGetCurrent( &pinfo->time );
-    prec->time = pinfo->time;
+  pinfo->writeStatus = OK;
+  if( !writer.request( pinfo, value.str ) ) {
+    fprintf( stderr, "\033[31;1m%s: Write queue of interface '%s' full, dropping value '%s'\033[0m\n",
+             prec->name, pinfo->interface, value.str );
+    recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM
+    return ERROR;
   }
 
-  myIsegHalThread->enable();
+  prec->pact = (epicsUInt8)true;
   return status;
 }
 
@@ -522,38 +1181,183 @@ long devIsegHalGlobalSwitchWrite( dbCommon *prec ) {
   devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
   devIsegHal_dset_t *pdset = (devIsegHal_dset_t *)prec->dset;
 
-  myIsegHalThread->disable();
-
-  char value[VALUE_SIZE];
-  value[0] = pinfo->object[0];
-  long status = pdset->conv_val_str( prec, value );
+  devIsegHal_value_t value;
+  value.str[0] = pinfo->object[0];
+  long status = pdset->conv_val_str( prec, &value );
   if( ERROR == status ) {
     fprintf( stderr, "\033[31;1m%s: Invalid type parameter, cannot create broadcast command.\033[0m\n", prec->name );
     recGblSetSevr( prec, SOFT_ALARM, INVALID_ALARM ); // Set record to SOFT_ALARM 
     return ERROR;
   }
 
-  if ( iseg_setItem( pinfo->interface, "Configuration", "1" ) != ISEG_OK ) {
-    fprintf( stderr, "\033[31;1m%s: Error while stopping data collector for sending broadcast.\033[0m\n",
-             prec->name );
+  std::vector< std::string > frames( 1, value.str );
+  double latency = 0.;
+  if( pollerOf( pinfo )->broadcast( frames, latency ) != OK ) {
+    fprintf( stderr, "\033[31;1m%s: Error while sending broadcast command.\033[0m\n", prec->name );
     recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM 
-    iseg_setItem( pinfo->interface, "Configuration", "0"); // Restore function
-    myIsegHalThread->enable();
     return ERROR; 
   }
-  if ( iseg_setItem( pinfo->interface, "Write", value ) != ISEG_OK ) {
-    fprintf( stderr, "\033[31;1m%s: Error while sending broadcast command.\033[0m\n",
-             prec->name );
+
+  if( -2 == prec->tse ) {
+    epicsTimeGetCurrent( &pinfo->time );
+    prec->time = pinfo->time;
+  }
+
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Store the prebuilt frames of an emergency off record
+//! @param [in]  prec  Address of record calling this function
+//! @param [in]  off   Frame to clear the emergency off
+//! @param [in]  on    Frame to set the emergency off
+//! @return      ERROR in case of an error, otherwise OK
+//------------------------------------------------------------------------------
+long devIsegHalEmergencyInit( dbCommon *prec, const char *off, const char *on ) {
+  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
+  if( !pinfo || !off || !on ) return ERROR;
+
+  isegHalEmergency* pemergency = new isegHalEmergency;
+  pemergency->frames[0] = off;
+  pemergency->frames[1] = on;
+  pinfo->pemergency = pemergency;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Send an emergency off
+//! @param [in]  prec  Address of record calling this function
+//! @param [in]  on    true to set, false to clear the emergency off
+//! @return      ERROR in case of an error, otherwise OK
+//!
+//! The prebuilt frame is sent directly, without conversion and without
+//! waiting for the polling thread or other broadcasts.
+//------------------------------------------------------------------------------
+long devIsegHalEmergencyWrite( dbCommon *prec, bool on ) {
+  epicsUInt64 requested = epicsMonotonicGet();
+  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
+  isegHalEmergency* pemergency = static_cast< isegHalEmergency* >( pinfo->pemergency );
+
+  if( pollerOf( pinfo )->emergency( pemergency->frames[ on ? 1 : 0 ], requested ) != OK ) {
+    fprintf( stderr, "\033[31;1m%s: Error while sending emergency off.\033[0m\n", prec->name );
     recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM 
-    iseg_setItem( pinfo->interface, "Configuration", "0"); // Restore function
-    myIsegHalThread->enable();
     return ERROR; 
   }
-  if ( iseg_setItem( pinfo->interface, "Configuration", "0" ) != ISEG_OK ) {
-    fprintf( stderr, "\033[31;1m%s: Error while starting data collector after sending broadcast.\033[0m\n",
-             prec->name );
+
+  if( -2 == prec->tse ) {
+    epicsTimeGetCurrent( &pinfo->time );
+    prec->time = pinfo->time;
+  }
+
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Benchmark of the emergency off path
+//! @param [in]  name    Name of an emergency off record ("@Emergency <Interface>")
+//! @param [in]  count   Number of frames to send
+//! @param [in]  on      true to send the frame setting, false the frame clearing the emergency off
+//! @param [in]  period  Time in seconds between two frames
+//! @return      ERROR if the record is no emergency off record or a frame could not be sent, otherwise OK
+//!
+//! The prebuilt frame of the record is sent repeatedly through the emergency
+//! off path while the polling thread of the interface keeps polling.
+//! The distribution of the time from the request to the return of the
+//! write and the number of polls meanwhile are printed.
+//! Only the frame matching the VAL field of the record is sent, so the
+//! benchmark never clears an emergency off set by the record, nor sets
+//! one the record does not show.
+//------------------------------------------------------------------------------
+static long emergencyBench( const char* name, unsigned count, bool on, double period ) {
+  DBADDR addr;
+  if( !name || dbNameToAddr( name, &addr ) != 0 ) {
+    fprintf( stderr, "\033[31;1mRecord '%s' not found\033[0m\n", name ? name : "" );
+    return ERROR;
+  }
+  dbCommon* prec = addr.precord;
+  std::string dtyp;
+  DBENTRY entry;
+  dbInitEntry( pdbbase, &entry );
+  if( 0 == dbFindRecord( &entry, prec->name ) && 0 == dbFindField( &entry, "DTYP" ) ) dtyp = dbGetString( &entry );
+  dbFinishEntry( &entry );
+  devIsegHal_info_t* pinfo = (devIsegHal_info_t*)prec->dpvt;
+  if( dtyp != "isegHALglobal" || !pinfo || !pinfo->pemergency ) {
+    fprintf( stderr, "\033[31;1m%s: not an emergency off record\033[0m\n", prec->name );
+    return ERROR;
+  }
+  epicsEnum16 val = 0;
+  long nRequest = 1;
+  if( dbGetField( &addr, DBR_ENUM, &val, NULL, &nRequest, NULL ) != 0 ) {
+    fprintf( stderr, "\033[31;1m%s: Cannot read VAL\033[0m\n", prec->name );
+    return ERROR;
+  }
+  if( ( val != 0 ) != on ) {
+    fprintf( stderr, "\033[31;1m%s: VAL is %u, refusing to %s the emergency off\033[0m\n",
+             prec->name, (unsigned)val, on ? "set" : "clear" );
+    return ERROR;
+  }
+  isegHalEmergency* pemergency = static_cast< isegHalEmergency* >( pinfo->pemergency );
+  std::string const& frame = pemergency->frames[ on ? 1 : 0 ];
+  isegHalThread* pthread = pollerOf( pinfo );
+
+  double cycles = 0., reads = 0.;
+  pthread->statistic( "Cycles", cycles );
+  pthread->statistic( "Reads", reads );
+
+  long status = OK;
+  unsigned long errors = 0;
+  isegHalHistogram histogram;
+  std::vector< double > latencies;
+  latencies.reserve( count );
+  epicsUInt64 start = epicsMonotonicGet();
+  for( unsigned i = 0; i < count; ++i ) {
+    epicsUInt64 requested = epicsMonotonicGet();
+    if( pthread->emergency( frame, requested ) != OK ) {
+      ++errors;
+      status = ERROR;
+    } else {
+      double latency = ( epicsMonotonicGet() - requested ) * 1e-9;
+      histogram.add( latency );
+      latencies.push_back( latency );
+    }
+    if( period > 0. ) epicsThreadSleep( period );
+  }
+  double duration = ( epicsMonotonicGet() - start ) * 1e-9;
+
+  double cyclesAfter = 0., readsAfter = 0.;
+  pthread->statistic( "Cycles", cyclesAfter );
+  pthread->statistic( "Reads", readsAfter );
+
+  printf( "%s: sent frame '%s' %u times in %.3lf s, %lu errors, %.0lf polls with %.0lf reads meanwhile\n",
+          prec->name, frame.c_str(), count, duration, errors, cyclesAfter - cycles, readsAfter - reads );
+  if( !latencies.empty() ) {
+    std::sort( latencies.begin(), latencies.end() );
+    size_t n = latencies.size();
+    printf( "  request to write return: min %.6lf s, median %.6lf s, 90%% %.6lf s, 99%% %.6lf s, max %.6lf s\n",
+            latencies.front(), latencies[ n / 2 ], latencies[ n * 9 / 10 ], latencies[ n * 99 / 100 ], latencies.back() );
+    histogram.report( "Emergency off, request to write return" );
+  }
+  return status;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Send a batch of broadcast frames
+//! @param [in]  prec    Address of record calling this function
+//! @param [in]  frames  Raw frames, separated by spaces, commas or semicolons
+//! @return      ERROR in case of an error, otherwise OK
+//!
+//! All frames are sent within one pause of the data collector of isegHAL.
+//------------------------------------------------------------------------------
+long devIsegHalBroadcastWrite( dbCommon *prec, const char *frames ) {
+  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
+
+  std::vector< std::string > batch = splitFrames( frames );
+  if( batch.empty() ) return OK;
+
+  double latency = 0.;
+  if( pollerOf( pinfo )->broadcast( batch, latency ) != OK ) {
+    fprintf( stderr, "\033[31;1m%s: Error while sending broadcast commands.\033[0m\n", prec->name );
     recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM 
-    myIsegHalThread->enable();
     return ERROR; 
   }
 
@@ -562,162 +1366,1835 @@ long devIsegHalGlobalSwitchWrite( dbCommon *prec ) {
     prec->time = pinfo->time;
   }
 
-  myIsegHalThread->enable();
   return OK;
 }
 
 //------------------------------------------------------------------------------
-//! @brief       C'tor of isegHalThread
+//! @brief       Store the value of an element in the array of a record
+//! @param [in]  pbuf  Address of the array
+//! @param [in]  ftvl  Field type of the array elements
+//! @param [in]  i     Index of the element
+//! @param [in]  pval  Value of the element
+//! @return      ERROR if the value cannot be stored in this array, otherwise OK
 //------------------------------------------------------------------------------
-isegHalThread::isegHalThread()
-  : thread( *this, "isegHAL", epicsThreadGetStackSize( epicsThreadStackSmall ), 50 ),
-    _run( true ),
-    _pause(5.),
-    _debug(0)
-{
-  _recs.clear();
+static long setArrayElement( void* pbuf, epicsEnum16 ftvl, size_t i, const devIsegHal_value_t* pval ) {
+  if( menuFtypeSTRING == ftvl ) {
+    char* pstr = static_cast< char* >( pbuf ) + i * MAX_STRING_SIZE;
+    strncpy( pstr, pval->str, MAX_STRING_SIZE - 1 );
+    pstr[MAX_STRING_SIZE - 1] = '\0';
+    return OK;
+  }
+  if( !pval->valid || devIsegHalTypeString == pval->type ) return ERROR;
+
+  epicsFloat64 val = ( devIsegHalTypeDouble == pval->type ) ? pval->dval : pval->uval;
+  switch( ftvl ) {
+    case menuFtypeCHAR:   static_cast< epicsInt8* >( pbuf )[i]    = (epicsInt8)val;    break;
+    case menuFtypeUCHAR:  static_cast< epicsUInt8* >( pbuf )[i]   = (epicsUInt8)val;   break;
+    case menuFtypeSHORT:  static_cast< epicsInt16* >( pbuf )[i]   = (epicsInt16)val;   break;
+    case menuFtypeUSHORT: static_cast< epicsUInt16* >( pbuf )[i]  = (epicsUInt16)val;  break;
+    case menuFtypeLONG:   static_cast< epicsInt32* >( pbuf )[i]   = (epicsInt32)val;   break;
+    case menuFtypeULONG:  static_cast< epicsUInt32* >( pbuf )[i]  = (epicsUInt32)val;  break;
+    case menuFtypeFLOAT:  static_cast< epicsFloat32* >( pbuf )[i] = (epicsFloat32)val; break;
+    case menuFtypeDOUBLE: static_cast< epicsFloat64* >( pbuf )[i] = val;               break;
+    default: return ERROR;
+  }
+  return OK;
 }
 
 //------------------------------------------------------------------------------
-//! @brief       D'tor of isegHalThread
+//! @brief       Convert an element of the array of a record to a cstring
+//! @param [in]  pbuf  Address of the array
+//! @param [in]  ftvl  Field type of the array elements
+//! @param [in]  i     Index of the element
+//! @param [out] pval  Value of the element, its type has to be set
+//! @return      ERROR if the element cannot be converted, otherwise OK
 //------------------------------------------------------------------------------
-isegHalThread::~isegHalThread() {
-  _recs.clear();
+static long getArrayElement( const void* pbuf, epicsEnum16 ftvl, size_t i, devIsegHal_value_t* pval ) {
+  if( menuFtypeSTRING == ftvl ) {
+    strncpy( pval->str, static_cast< const char* >( pbuf ) + i * MAX_STRING_SIZE, MAX_STRING_SIZE );
+    pval->str[MAX_STRING_SIZE - 1] = '\0';
+    return OK;
+  }
+
+  epicsFloat64 val = 0.;
+  switch( ftvl ) {
+    case menuFtypeCHAR:   val = static_cast< const epicsInt8* >( pbuf )[i];    break;
+    case menuFtypeUCHAR:  val = static_cast< const epicsUInt8* >( pbuf )[i];   break;
+    case menuFtypeSHORT:  val = static_cast< const epicsInt16* >( pbuf )[i];   break;
+    case menuFtypeUSHORT: val = static_cast< const epicsUInt16* >( pbuf )[i];  break;
+    case menuFtypeLONG:   val = static_cast< const epicsInt32* >( pbuf )[i];   break;
+    case menuFtypeULONG:  val = static_cast< const epicsUInt32* >( pbuf )[i];  break;
+    case menuFtypeFLOAT:  val = static_cast< const epicsFloat32* >( pbuf )[i]; break;
+    case menuFtypeDOUBLE: val = static_cast< const epicsFloat64* >( pbuf )[i]; break;
+    default: return ERROR;
+  }
+
+  int n = -1;
+  if( devIsegHalTypeDouble == pval->type )    n = sprintf( pval->str, "%lf", val );
+  else if( devIsegHalTypeUInt == pval->type ) n = sprintf( pval->str, "%u", (epicsUInt32)val );
+  return ( n < 0 ) ? ERROR : OK;
 }
 
 //------------------------------------------------------------------------------
-//! @brief       Run operation of thread
+//! @brief       Load the values of all elements into the array of a record
+//! @param [in]  pinfo  Address of the array record's private data structure
+//! @return      ERROR if a value could not be stored, otherwise OK
 //!
-//! Go through the list of registered records and check the cached value
-//! from isegHAL.
-//! If the cached value differs from the current value in the record,
-//! the record will be updated.
-//! After having checked all records, the thread sleeps for 5 seconds and
-//! repeats the check.
+//! The values are loaded from the items polled by the polling thread.
+//! The timestamp is set to the latest change of all elements.
 //------------------------------------------------------------------------------
-void isegHalThread::run() {
-  while( true ) {
-    std::list<devIsegHal_info_t*>::iterator it = _recs.begin();
-    if( _pause > 0. ) this->thread.sleep( _pause ); 
+static long loadArray( devIsegHal_info_t* pinfo ) {
+  isegHalArray* parray = static_cast< isegHalArray* >( pinfo->parray );
+  void* pbuf = *parray->array.pbptr;
+  long status = OK;
+  for( size_t i = 0; i < parray->elements.size(); ++i ) {
+    devIsegHal_info_t* pelem = parray->elements[i];
+    static_cast< isegHalItem* >( pelem->pitem )->slot.load( &pelem->value, &pelem->time );
+    if( setArrayElement( pbuf, parray->array.ftvl, i, &pelem->value ) != OK ) status = ERROR;
+    if( 0 == i || epicsTimeDiffInSeconds( &pelem->time, &pinfo->time ) > 0. ) pinfo->time = pelem->time;
+  }
+  *parray->array.pnord = parray->elements.size();
+  return status;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Initialization of aai, aao and waveform records
+//! @param [in]  prec       Address of the record calling this function
+//! @param [in]  pconf      Address of record configuration
+//! @param [in]  parr       Address of the array configuration
+//! @return      In case of error return -1, otherwise return 0
+//!
+//! The INP/OUT field names an item of all channels of a module,
+//! e.g. "@0.0.*.VoltageMeasure can0". The array has one element per
+//! channel, limited to NELM elements.
+//------------------------------------------------------------------------------
+long devIsegHalArrayInitRecord( dbCommon *prec, const devIsegHal_rec_t *pconf, const devIsegHal_array_t *parr ) {
 
-    if( !_run ) continue;
+  std::vector< std::string > options;
+  if( !splitLink( prec, pconf, options ) ) return ERROR;
+
+  // the pattern has the form "line.module.*.item"
+  size_t star = std::string::npos;
+  if( options.size() == 2 || options.size() == 3 ) {
+    std::string const& pattern = options.at(0);
+    size_t dot = pattern.find( '.' );
+    if( dot != std::string::npos ) dot = pattern.find( '.', dot + 1 );
+    if(    dot != std::string::npos && pattern.compare( dot, 3, ".*." ) == 0
+        && std::count( pattern.begin(), pattern.end(), '.' ) == 3 ) star = dot;
+  }
+  if( std::string::npos == star ) {
+    std::cerr << prec->name << ": Invalid INP/OUT field: " << pconf->ioLink->value.instio.string << "\n"
+              << "    Syntax is \"@<line>.<module>.*.<isegItem> <Interface> [<PollClass>]\"" << std::endl;
+    return ERROR;
+  }
+  std::string module = options.at(0).substr( 0, star );
+  std::string leaf   = options.at(0).substr( star + 3 );
 
-    // some "benchmarking"
-    struct timespec	start;
-#ifdef _POSIX_CPUTIME
-	clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &start );
-#else
-	clock_gettime( CLOCK_MONOTONIX, &start );
-#endif
+  // Test if interface is connected to isegHAL server
+  if( !isegHalConnectionHandler::instance().connected( options.at(1) ) ) {
+    std::cerr << "\033[31;1m" << "isegHal interface " << options.at(1) << " not connected!"
+              << "\033[0m" << std::endl;
+    return ERROR;
+  }
+
+  std::string object = module + ".ChannelNumber";
+  IsegItem channels = iseg_getItem( options.at(1).c_str(), object.c_str() );
+  epicsUInt32 nchannels = 0;
+  if(    strcmp( channels.quality, ISEG_ITEM_QUALITY_OK ) != 0
+      || devIsegHalParseUInt32( channels.value, &nchannels ) != OK ) {
+    fprintf( stderr, "\033[31;1m%s: Error while reading number of channels '%s' (Q: %s)\033[0m\n",
+             prec->name, object.c_str(), channels.quality );
+    return ERROR;
+  }
+  if( nchannels > parr->nelm ) {
+    fprintf( stderr, "%s: Module '%s' has %u channels, only the first %u are used (NELM)\n",
+             prec->name, module.c_str(), nchannels, parr->nelm );
+    nchannels = parr->nelm;
+  }
 
-    for( ; it != _recs.end(); ++it ) {
+  // check the items of all channels before anything is allocated
+  std::vector< IsegItemProperty > properties;
+  for( epicsUInt32 ch = 0; ch < nchannels; ++ch ) {
+    std::ostringstream os;
+    os << module << "." << ch << "." << leaf;
+    IsegItemProperty isegItem = isegHalPropertyCache::instance().get( options.at(1), os.str() );
+    if( !checkItemProperty( prec, pconf, os.str().c_str(), isegItem, pconf->type ) ) return ERROR;
+    properties.push_back( isegItem );
+  }
+  if( properties.empty() ) {
+    fprintf( stderr, "\033[31;1m%s: Module '%s' has no channels\033[0m\n", prec->name, module.c_str() );
+    return ERROR;
+  }
 
-      if( 3 <= _debug )
-        printf( "isegHalThread::run: Reading item '%s'\n", (*it)->object );
+  /// Poll class from INP/OUT field or info tag
+  isegHalPollClass* pclass = recordPollClass( prec, options );
+  if( !pclass ) return ERROR;
 
-      IsegItem item = iseg_getItem( (*it)->interface, (*it)->object );
-      if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) continue;
+  isegHalThread* pthread = isegHalConnectionHandler::instance().poller( options.at(1) );
+  isegHalArray* parray = new isegHalArray;
+  parray->array  = *parr;
+  parray->pgroup = pthread->scanGroup( options.at(0) );
 
-      epicsUInt32 seconds = 0;
-      epicsUInt32 microsecs = 0;
-      if( sscanf( item.timeStampLastChanged, "%u.%u", &seconds, &microsecs ) != 2 ) continue;
-      epicsTimeStamp time;
-      time.secPastEpoch = seconds - POSIX_TIME_AT_EPICS_EPOCH;
-      time.nsec = microsecs * 100000;
+  devIsegHal_info_t *pinfo = new devIsegHal_info_t;
+  memset( pinfo, 0, sizeof( devIsegHal_info_t ) );
+  strncpy( pinfo->object, options.at(0).c_str(), FULLY_QUALIFIED_OBJECT_SIZE - 1 );
+  strncpy( pinfo->interface, options.at(1).c_str(), 20 );
+  memcpy( pinfo->unit, properties.front().unit, UNIT_SIZE );
+  pinfo->value.type = devIsegHalParseType( properties.front().type );
+  pinfo->prec = prec;
+  pinfo->output = pconf->registerCallback;
+  callbackSetCallback( readbackCallback, &pinfo->readbackCallback );
+  callbackSetUser( pinfo, &pinfo->readbackCallback );
+  pinfo->writeStatus = OK;
+  pinfo->windowError = 0;
+  pinfo->writeErrors = 0;
+  pinfo->ppoller = pthread;
+  pinfo->pollIndex = -1;
+  pinfo->ioscanpvt = parray->pgroup->ioscanpvt;
+  pinfo->parray = parray;
+
+  pinfo->pclass = pclass;
+
+  /// Elements are polled like scalar records of the same item,
+  /// the readbacks of aao records like those of scalar output records
+  bool deferred = false;
+  std::vector< IsegItemProperty >::const_iterator it = properties.begin();
+  for( ; it != properties.end(); ++it ) {
+    devIsegHal_info_t *pelem = new devIsegHal_info_t;
+    memset( pelem, 0, sizeof( devIsegHal_info_t ) );
+    memcpy( pelem->object, it->object, FULLY_QUALIFIED_OBJECT_SIZE );
+    strncpy( pelem->interface, options.at(1).c_str(), 20 );
+    memcpy( pelem->unit, it->unit, UNIT_SIZE );
+    pelem->value.type = devIsegHalParseType( it->type );
+    pelem->prec = prec;
+    pelem->output = pinfo->output;
+    pelem->writeStatus = OK;
+    pelem->ppoller = pthread;
+    pelem->pclass = pinfo->pclass;
+    pelem->pollIndex = -1;
+    pelem->pparent = pinfo;
+
+    readInitialValue( prec, pelem );
+    deferred |= ( pelem->stale && !pelem->value.valid );
+    pelem->pitem = pthread->item( pelem );
+    pelem->ioscanpvt = parray->pgroup->ioscanpvt;
+    // elements of input records are only polled while the record is I/O Intr
+    if( pinfo->output ) pthread->registerInterrupt( prec, pelem );
+    parray->elements.push_back( pelem );
+  }
 
-      if(   (*it)->time.secPastEpoch != time.secPastEpoch
-        ||  (*it)->time.nsec         != time.nsec         ) {
+  if( deferred ) {
+    // values are fetched after iocInit, cleared by the first update from isegHAL
+    prec->stat = UDF_ALARM;
+    prec->sevr = INVALID_ALARM;
+  } else if( loadArray( pinfo ) != OK ) {
+    fprintf( stderr, "\033[31;1m%s: Error converting values of '%s'\033[0m\n", prec->name, pinfo->object );
+  }
+  if( -2 == prec->tse ) prec->time = pinfo->time;
 
-        if( 2 <= _debug )
-          printf( "isegHalThread::run: New value for item '%s': %s -> %s\n",
-                  (*it)->object, (*it)->value, item.value );
-        // value was updated in isegHAL
-        memcpy( (*it)->value, item.value, VALUE_SIZE );
-        (*it)->time = time;
-        callbackRequest( (*it)->pcallback );
-      }
-    }
+  prec->dpvt = pinfo;
+  prec->udf  = (epicsUInt8)( deferred && !pinfo->output );
 
-    // some "benchmarking"
+  return OK;
+}
 
-    if( 1 <= _debug ) {
-      struct timespec	stop;
-#ifdef _POSIX_CPUTIME
-	  clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &stop );
-#else
-	  clock_gettime( CLOCK_MONOTONIX, &stop );
-#endif
-      printf( "isegHalThread::run: needed %lf seconds for %lu records\n",
-               timespec_diff( &stop, &start ), (unsigned long)_recs.size() );
-	}
+//------------------------------------------------------------------------------
+//! @brief       Read the values of all elements of an array record from isegHAL
+//! @param [in]  prec   Address of the record
+//! @param [in]  pinfo  Address of the private data of the array record
+//! @return      ERROR if an element cannot be read or converted, otherwise OK
+//------------------------------------------------------------------------------
+static long readArray( dbCommon* prec, devIsegHal_info_t* pinfo ) {
+  isegHalArray* parray = static_cast< isegHalArray* >( pinfo->parray );
+  void* pbuf = *parray->array.pbptr;
+  long status = OK;
+  for( size_t i = 0; i < parray->elements.size(); ++i ) {
+    devIsegHal_info_t* pelem = parray->elements[i];
+    IsegItem item = iseg_getItem( pelem->interface, pelem->object );
+    if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) {
+      fprintf( stderr, "\033[31;1m%s: Error while reading value '%s' from interface '%s': '%s' (Q: %s)\033[0m\n",
+               prec->name, item.object, pelem->interface, item.value, item.quality );
+      return ERROR;
+    }
+    if( devIsegHalParseTime( item.timeStampLastChanged, &pelem->time ) != OK ) {
+      fprintf( stderr, "\033[31;1m%s: Error parsing timestamp for '%s': %s\033[0m\n", prec->name, pelem->object, item.timeStampLastChanged );
+      return ERROR;
+    }
+    memcpy( pelem->value.str, item.value, VALUE_SIZE );
+    devIsegHalParseValue( &pelem->value );
+    if( setArrayElement( pbuf, parray->array.ftvl, i, &pelem->value ) != OK ) status = ERROR;
+    if( 0 == i || epicsTimeDiffInSeconds( &pelem->time, &pinfo->time ) > 0. ) pinfo->time = pelem->time;
   }
+  *parray->array.pnord = parray->elements.size();
+  return status;
 }
 
 //------------------------------------------------------------------------------
-//! @brief       Add a record to the list
-//! @param [in]  prec  Address of the record to be added
+//! @brief       Read function of aai and waveform records
+//! @param [in]  prec  Address of record calling this funciton
+//! @return      ERROR in case of an error, otherwise OK
 //!
-//! Registers a new record to be checked by the thread
+//! Records processed by I/O Intr are filled with the values from the
+//! polling thread, which only polls the elements of I/O Intr records.
+//! Otherwise the elements are read from isegHAL.
 //------------------------------------------------------------------------------
-void isegHalThread::registerInterrupt( dbCommon* prec, devIsegHal_info_t *pinfo ) {
-  //devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
-  if( !pinfo->pcallback ) {
-    CALLBACK *pcallback = new CALLBACK;
-    callbackSetCallback( devIsegHalCallback, pcallback );
-    callbackSetUser( (void*)prec, pcallback );
-    callbackSetPriority( priorityLow, pcallback );
-    pinfo->pcallback = pcallback;
+long devIsegHalArrayRead( dbCommon *prec ) {
+  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
+
+  long status = ( menuScanI_O_Intr == prec->scan ) ? loadArray( pinfo ) : readArray( prec, pinfo );
+  if( status != OK ) {
+    fprintf( stderr, "\033[31;1m%s: Error converting values of '%s'\033[0m\n", prec->name, pinfo->object );
+    recGblSetSevr( prec, READ_ALARM, INVALID_ALARM ); // Set record to READ_ALARM
+    return ERROR;
   }
 
-  if( 1 <= _debug )
-    printf( "isegHalThread: Register new record '%s'\n", prec->name );
+  if( -2 == prec->tse ) {
+    // timestamp is set by device support
+    prec->time = pinfo->time;
+  }
+  prec->udf = (epicsUInt8)false;
 
-  _recs.push_back( pinfo );
-  // to be sure that each record is only added once
-  _recs.sort();
-  _recs.unique();
+  return OK;
 }
 
 //------------------------------------------------------------------------------
-//! @brief       Remove a record to the list
-//! @param [in]  pinfo  Address of the record's private data structure
+//! @brief       Write function of aao records
+//! @param [in]  prec   Address of record calling this function
+//! @return      ERROR in case of an error, otherwise OK
 //!
-//! Removes a record from the list which is checked by the thread for updates
+//! The first NORD elements are queued as one batch to the writer thread.
+//! Like scalar records the record stays active until all elements have
+//! been written, or completes immediately if a write window is set.
+//! Nothing is written while the initial value of a deferred element has
+//! not been fetched yet.
 //------------------------------------------------------------------------------
-void isegHalThread::cancelInterrupt( const devIsegHal_info_t* pinfo ) {
-  std::list<devIsegHal_info_t*>::iterator it = _recs.begin();
-  for( ; it != _recs.end(); ++it ) {
-    if( pinfo == (*it) ) {
-      _recs.erase( it );
-      break;
+long devIsegHalArrayWrite( dbCommon *prec ) {
+  devIsegHal_info_t *pinfo = (devIsegHal_info_t *)prec->dpvt;
+  isegHalArray* parray = static_cast< isegHalArray* >( pinfo->parray );
+
+  if( prec->pact ) {
+    // completion of an asynchronous write
+    epicsAtomicSetIntT( &pinfo->readback, 0 );
+    if( ERROR == pinfo->writeStatus ) {
+      recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM
+      return ERROR;
     }
-  } 
-}
+    if( -2 == prec->tse ) {
+      epicsTimeGetCurrent( &pinfo->time );
+      prec->time = pinfo->time;
+    }
+    return OK;
+  }
 
-// Configuration routines.  Called from the iocsh function below 
-extern "C" {
+  // record processed by the dispatcher, any other processing writes
+  if( pinfo->inReadback ) {
+    // readback already discarded by a write, keep the record as it is
+    if( !epicsAtomicCmpAndSwapIntT( &pinfo->readback, 1, 0 ) ) return OK;
+    // use readback values from polling thread
+    long status = loadArray( pinfo );
+    if( -2 == prec->tse ) prec->time = pinfo->time;
+    prec->udf = (epicsUInt8)false;
+    if( windowWriteFailed( prec, pinfo ) ) return ERROR;
+    return status;
+  }
 
-  static const iocshArg isegConnectArg0 = { "port", iocshArgString };
-  static const iocshArg isegConnectArg1 = { "tty",  iocshArgString };
-  static const iocshArg * const isegConnectArgs[] = { &isegConnectArg0, &isegConnectArg1 };
-  static const iocshFuncDef isegConnectFuncDef = { "isegHalConnect", 2, isegConnectArgs };
+  // a write supersedes a pending readback
+  epicsAtomicSetIntT( &pinfo->readback, 0 );
+
+  size_t nord = *parray->array.pnord;
+  if( nord > parray->elements.size() ) nord = parray->elements.size();
+  if( 0 == nord ) return OK;
+  std::vector< devIsegHal_info_t* > elements( parray->elements.begin(), parray->elements.begin() + nord );
+  for( size_t i = 0; i < nord; ++i ) {
+    // initial value not fetched yet, VAL is still the default of the database
+    if( elements[i]->stale && !elements[i]->value.valid ) {
+      fprintf( stderr, "\033[31;1m%s: Initial value of '%s' not read yet, not writing\033[0m\n",
+               prec->name, elements[i]->object );
+      recGblSetSevr( prec, UDF_ALARM, INVALID_ALARM ); // Set record to UDF_ALARM
+      return ERROR;
+    }
+  }
+  std::vector< devIsegHal_value_t > values( nord );
+  for( size_t i = 0; i < nord; ++i ) {
+    values[i].type = elements[i]->value.type;
+    if( getArrayElement( *parray->array.pbptr, parray->array.ftvl, i, &values[i] ) != OK ) {
+      fprintf( stderr, "\033[31;1m%s: Error converting element %lu for '%s'\033[0m\n",
+               prec->name, (unsigned long)i, elements[i]->object );
+      recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM
+      return ERROR;
+    }
+  }
 
-  //----------------------------------------------------------------------------
-  //! @brief       iocsh callable function to connect to isegHalServer
-  //!
-  //! This function can be called from the iocsh via "isegHalConnect( PORT, TTY )"
-  //! PORT is the deviseg internal name of the interface which is also used inside
-  //! the records.
-  //! TTY is the name of the hardware interface (e.g. "can0").
-  //----------------------------------------------------------------------------
-  static void isegConnectCallFunc( const iocshArgBuf *args ) {
-    std::cout << "using HAL version [" << iseg_getVersionString() << "]" << std::endl;
-    if( !isegHalConnectionHandler::instance().connect( args[0].sval, args[1].sval ) ){
-      fprintf( stderr, "\033[31;1mCannot connect to isegHAL interface %s(%s)\033[0m\n", args[0].sval, args[1].sval );
+  isegHalWriter& writer = pollerOf( pinfo )->writer;
+  if( writer.window() > 0. ) {
+    // last value wins, a failed write is reported by the next processing
+    bool failed = windowWriteFailed( prec, pinfo );
+    for( size_t i = 0; i < nord; ++i ) {
+      if( !writer.post( elements[i], values[i].str ) ) {
+        fprintf( stderr, "\033[31;1m%s: Write queue of interface '%s' full, dropping value '%s'\033[0m\n",
+                 prec->name, pinfo->interface, values[i].str );
+        recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM
+        return ERROR;
+      }
     }
+    if( -2 == prec->tse ) {
+      epicsTimeGetCurrent( &pinfo->time );
+      prec->time = pinfo->time;
+    }
+    return failed ? ERROR : OK;
   }
 
-  // iocsh callable function to set options for polling thread
+  pinfo->writeStatus = OK;
+  if( !writer.request( pinfo, elements, values ) ) {
+    fprintf( stderr, "\033[31;1m%s: Write queue of interface '%s' full, dropping %lu values\033[0m\n",
+             prec->name, pinfo->interface, (unsigned long)nord );
+    recGblSetSevr( prec, WRITE_ALARM, INVALID_ALARM ); // Set record to WRITE_ALARM
+    return ERROR;
+  }
+
+  prec->pact = (epicsUInt8)true;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       C'tor of isegHalThread
+//! @param [in]  interface   deviseg internal name of the interface handle
+//!
+//! Creates the predefined poll classes "fast" (1 s), "default" (5 s)
+//! and "slow" (60 s).
+//------------------------------------------------------------------------------
+isegHalThread::isegHalThread( std::string const& interface )
+  : thread( *this, ( "isegHAL:" + interface ).c_str(), epicsThreadGetStackSize( epicsThreadStackSmall ), 50 ),
+    writer( interface, writeQueueDepth ),
+    _interface( interface ),
+    _lane(0),
+    _run( true ),
+    _debug(0),
+    _hierarchical( false ),
+    _fullSweep( 60. ),
+    _cycleGate( true ),
+    _halCycle( 0. ),
+    _lastCycleCounter( 0 ),
+    _lastCycleTime( 0. ),
+    _cycleCounterValid( false ),
+    _followWindow( 0. ),
+    _followPeriod( 0.2 ),
+    _followSettle( 3 ),
+    _followDue( 0. ),
+    _deferInit( false ),
+    _epoch( epicsMonotonicGet() ),
+    _paused( 0 ),
+    _fetchRequested( false ),
+    _overruns(0),
+    _reads(0),
+    _skipped(0),
+    _unchanged(0),
+    _scanRequests(0),
+    _readbacks(0),
+    _coalesced(0),
+    _deferred(0),
+    _broadcasts(0),
+    _broadcastFrames(0),
+    _broadcastErrors(0),
+    _emergencies(0),
+    _emergencyErrors(0),
+    _emergencyPauseErrors(0),
+    _followed(0),
+    _followReads(0),
+    _followSettled(0),
+    _followExpired(0),
+    _initFetched(0),
+    _initFailed(0),
+    _initFetchTime(0.)
+{
+  _emergencyTime.secPastEpoch = 0;
+  _emergencyTime.nsec = 0;
+  changeIntervall( "fast",     1. );
+  changeIntervall( "default",  5. );
+  changeIntervall( "slow",    60. );
+  setRelated( "VoltageSet", "VoltageMeasure" );
+  setRelated( "CurrentSet", "CurrentMeasure" );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       D'tor of isegHalThread
+//------------------------------------------------------------------------------
+isegHalThread::~isegHalThread() {
+  std::map< std::string, isegHalPollClass* >::iterator it = _classes.begin();
+  for( ; it != _classes.end(); ++it ) delete it->second;
+  _classes.clear();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Current time of the scheduler
+//! @return      Seconds since creation of the thread
+//!
+//! The monotonic clock is used, so the schedule is not affected by
+//! changes of the system time.
+//------------------------------------------------------------------------------
+double isegHalThread::now() const {
+  return ( epicsMonotonicGet() - _epoch ) * 1e-9;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Run operation of thread
+//!
+//! Wait until the next poll class is due and check the cached values
+//! of all its records from isegHAL.
+//! Afterwards the poll class is rescheduled to its next deadline, which
+//! is one period after the previous deadline. If this deadline has already
+//! passed, the missed polls are counted as overruns and skipped.
+//! If isegHAL collects its data slower than the period of the poll class,
+//! the cycle period of isegHAL is used instead.
+//! Items followed after a write are read in between whenever the
+//! fast-follow period is due before the next poll class.
+//------------------------------------------------------------------------------
+void isegHalThread::run() {
+  while( true ) {
+    _lock.lock();
+    // drop entries of poll classes which have been rescheduled meanwhile
+    while( _schedule.top().first != _schedule.top().second->due ) _schedule.pop();
+    deadline_t next = _schedule.top();
+    bool following = ( !_follows.empty() || !_followRequests.empty() ) && _followDue < next.first;
+    double followDue = _followDue;
+    bool fetching = _fetchRequested;
+    _fetchRequested = false;
+    // scan groups the worker could not scan are dispatched again
+    std::vector< isegHalScanGroup* >::iterator qit = _requeuedGroups.begin();
+    for( ; qit != _requeuedGroups.end(); ++qit ) {
+      if( epicsAtomicGetIntT( &(*qit)->pending ) ) continue;
+      epicsAtomicSetIntT( &(*qit)->pending, 1 );
+      _pendingGroups.push_back( *qit );
+    }
+    _requeuedGroups.clear();
+    _lock.unlock();
+
+    if( fetching ) {
+      fetch();
+      continue;
+    }
+
+    bool deferred = ( !_pendingGroups.empty() || !_pendingReadbacks.empty() );
+    if( deferred ) dispatch();
+
+    if( following && followDue <= now() ) {
+      followUp();
+      continue;
+    }
+
+    double wait = ( following ? followDue : next.first ) - now();
+    if( wait > 0. ) {
+      // retry deferred updates soon
+      if( deferred && wait > dispatchRetry ) wait = dispatchRetry;
+      // wake up early if the schedule is changed
+      _wakeup.wait( wait );
+      continue;
+    }
+
+    // wake-up jitter: delay between deadline and start of poll
+    _lock.lock();
+    _jitter.add( -wait );
+    _lock.unlock();
+
+    if( _run && halCycleAdvanced( next.second ) ) poll( next.second );
+
+    _lock.lock();
+    if( next.second->due == next.first ) {
+      double current = now();
+      double period  = next.second->period;
+      if( _cycleGate && _halCycle > period ) period = _halCycle;
+      if( period <= 0. ) {
+        next.second->due = current;
+      } else {
+        next.second->due += period;
+        if( next.second->due <= current ) {
+          // deadline missed, skip to the next one in the future
+          double missed = floor( ( current - next.second->due ) / period ) + 1.;
+          next.second->due += missed * period;
+          next.second->overruns += (unsigned long)missed;
+          _overruns += (unsigned long)missed;
+        }
+      }
+      _schedule.push( deadline_t( next.second->due, next.second ) );
+    }
+    _lock.unlock();
+  }
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Poll all items of a poll class
+//! @param [in]  pclass  Address of the poll class
+//!
+//! Go through the list of items of this poll class and check the
+//! cached value from isegHAL.
+//! If the timestamp of the last change differs, the value cstring is
+//! parsed once. Only if the parsed value differs from the current value
+//! of the item, all records using this item will be updated.
+//! In hierarchical mode channel items are skipped if the registers of
+//! their module did not change, unless a full sweep is due.
+//------------------------------------------------------------------------------
+void isegHalThread::poll( isegHalPollClass* pclass ) {
+  double start = now();
+  unsigned long reads = 0;
+  unsigned long skipped = 0;
+  unsigned long coalesced = 0;
+
+  bool sweep = !_hierarchical || pclass->lastSweep < 0. || start - pclass->lastSweep >= _fullSweep;
+  if( sweep ) pclass->lastSweep = start;
+
+  std::vector<isegHalItem*> const& items = pclass->items.snapshot();
+  std::vector<isegHalItem*>::const_iterator it = items.begin();
+  for( ; it != items.end(); ++it ) {
+
+    // the registers are also checked during a full sweep to keep them up to date
+    if( _hierarchical && !(*it)->module.empty()
+        && !moduleActive( pclass, (*it)->module ) && !sweep ) {
+      ++skipped;
+      continue;
+    }
+    ++reads;
+    read( *it, coalesced );
+  }
+
+  double duration = now() - start;
+  _lock.lock();
+  _cycleTime.add( duration );
+  ++pclass->cycles;
+  pclass->reads   += reads;
+  pclass->skipped += skipped;
+  _reads   += reads;
+  _skipped += skipped;
+  _coalesced += coalesced;
+  _lock.unlock();
+
+  dispatch();
+
+  if( 1 <= _debug ) {
+    printf( "isegHalThread(%s)::run: needed %lf seconds for %lu of %lu items of class '%s'%s\n",
+             _interface.c_str(), duration, reads, (unsigned long)items.size(), pclass->name.c_str(),
+             ( _hierarchical && sweep ) ? " (full sweep)" : "" );
+  }
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Read an item from isegHAL
+//! @param [in]  pitem      Address of the item
+//! @param [out] coalesced  Incremented for each update merged into a pending one
+//! @return      true if the value of the item changed, otherwise false
+//!
+//! If the timestamp of the last change differs, the value cstring is
+//! parsed once. Only if the parsed value differs from the current value
+//! of the item, the records using this item are marked for update.
+//------------------------------------------------------------------------------
+bool isegHalThread::read( isegHalItem* pitem, unsigned long& coalesced ) {
+  if( 3 <= _debug )
+    printf( "isegHalThread(%s)::run: Reading item '%s'\n", _interface.c_str(), pitem->object );
+
+  IsegItem item = iseg_getItem( pitem->interface, pitem->object );
+  if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) return false;
+
+  epicsTimeStamp time;
+  if( devIsegHalParseTime( item.timeStampLastChanged, &time ) != OK ) return false;
+
+  // the polling thread is the only writer of the slot, no need to load it
+  isegHalSlot& slot = pitem->slot;
+  if(   slot.time.secPastEpoch == time.secPastEpoch
+    &&  slot.time.nsec         == time.nsec
+    &&  !pitem->stale ) return false;
+
+  devIsegHal_value_t value;
+  value.type = slot.value.type;
+  memcpy( value.str, item.value, VALUE_SIZE );
+  devIsegHalParseValue( &value );
+  // a value from the snapshot file is confirmed by updating the records
+  bool changed = !devIsegHalValueEqual( &value, &slot.value ) || pitem->stale;
+  pitem->stale = false;
+  if( changed && 2 <= _debug )
+    printf( "isegHalThread(%s)::run: New value for item '%s': %s -> %s\n",
+            _interface.c_str(), pitem->object, slot.value.str, item.value );
+  slot.store( value, time );
+  // value was only refreshed in isegHAL
+  if( !changed ) return false;
+
+  // value was updated in isegHAL, the records load it from the slot
+  std::vector<devIsegHal_info_t*> const& recs = pitem->subscribers.snapshot();
+  std::vector<devIsegHal_info_t*>::const_iterator rit = recs.begin();
+  bool inputs = false;
+  for( ; rit != recs.end(); ++rit ) {
+    // elements of array records update the whole record
+    devIsegHal_info_t* pinfo = (*rit)->pparent ? static_cast< devIsegHal_info_t* >( (*rit)->pparent ) : *rit;
+    if( !pinfo->output ) {
+      inputs = true;
+    } else if( epicsAtomicCmpAndSwapIntT( &pinfo->readback, 0, 1 ) != 0 ) {
+      // previous readback not yet processed, it will use the new value
+      ++coalesced;
+    } else if( !pinfo->pending ) {
+      pinfo->pending = true;
+      _pendingReadbacks.push_back( pinfo );
+    }
+  }
+  if( inputs ) {
+    isegHalScanGroup* pgroup = pitem->pgroup;
+    if( !epicsAtomicGetIntT( &pgroup->pending ) ) {
+      epicsAtomicSetIntT( &pgroup->pending, 1 );
+      _pendingGroups.push_back( pgroup );
+    } else if( pgroup->deferred ) {
+      ++coalesced;
+    }
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Request fetching the initial values of all stale items
+//!
+//! Called once the IOC is running, so the records can be scanned.
+//------------------------------------------------------------------------------
+void isegHalThread::requestFetch() {
+  _lock.lock();
+  _fetchRequested = true;
+  _lock.unlock();
+  _wakeup.signal();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Dispatch a scan group again
+//! @param [in]  pgroup  Address of the scan group
+//!
+//! Called by a worker if the records of the group could not be scanned,
+//! e.g. since scanning does not run yet or is paused.
+//------------------------------------------------------------------------------
+void isegHalThread::requeue( isegHalScanGroup* pgroup ) {
+  _lock.lock();
+  _requeuedGroups.push_back( pgroup );
+  _lock.unlock();
+  _wakeup.signal();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Fetch the initial values of all stale items
+//!
+//! Requested once the IOC is running (initHookAfterIocRunning). Items whose
+//! initialization was deferred or whose value was taken from the snapshot
+//! file are read in one pass, independent of their poll class, and their
+//! records are updated. Items which cannot be read stay stale and are
+//! updated by the first successful poll.
+//------------------------------------------------------------------------------
+void isegHalThread::fetch() {
+  double start = now();
+  std::vector< isegHalItem* > items;
+  _lock.lock();
+  std::map< std::string, isegHalItem* >::const_iterator it = _items.begin();
+  for( ; it != _items.end(); ++it ) {
+    if( it->second->stale ) items.push_back( it->second );
+  }
+  _lock.unlock();
+  if( items.empty() ) return;
+
+  unsigned long fetched = 0;
+  unsigned long coalesced = 0;
+  std::vector< isegHalItem* >::const_iterator iit = items.begin();
+  for( ; iit != items.end(); ++iit ) {
+    read( *iit, coalesced );
+    if( !(*iit)->stale ) ++fetched;
+  }
+  double duration = now() - start;
+
+  _lock.lock();
+  _initFetched   = fetched;
+  _initFailed    = items.size() - fetched;
+  _initFetchTime = duration;
+  _coalesced    += coalesced;
+  _lock.unlock();
+
+  dispatch();
+
+  printf( "isegHAL interface '%s': fetched %lu initial values in %.3lf s\n",
+          _interface.c_str(), fetched, duration );
+  if( fetched < items.size() ) {
+    fprintf( stderr, "\033[31;1misegHAL interface '%s': %lu initial values could not be read\033[0m\n",
+             _interface.c_str(), (unsigned long)items.size() - fetched );
+  }
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Read the items followed after a write
+//!
+//! New follow requests are merged first, a request for an item already
+//! followed restarts its window.
+//! An item is no longer followed once its value changed and then stayed
+//! unchanged for the configured number of reads, or its window expired.
+//! The time from the write to the first change is recorded as readback latency.
+//------------------------------------------------------------------------------
+void isegHalThread::followUp() {
+  _lock.lock();
+  std::vector< isegHalFollow >::const_iterator rit = _followRequests.begin();
+  for( ; rit != _followRequests.end(); ++rit ) {
+    std::vector< isegHalFollow >::iterator it = _follows.begin();
+    for( ; it != _follows.end() && it->pitem != rit->pitem; ++it ) {}
+    if( it == _follows.end() ) _follows.push_back( *rit );
+    else *it = *rit;
+  }
+  _followRequests.clear();
+  unsigned settle = _followSettle;
+  _lock.unlock();
+
+  unsigned long reads = 0;
+  unsigned long settled = 0;
+  unsigned long expired = 0;
+  unsigned long coalesced = 0;
+  std::vector< double > latencies;
+  std::vector< isegHalFollow >::iterator it = _follows.begin();
+  while( it != _follows.end() ) {
+    bool changed = false;
+    if( _run ) {
+      changed = read( it->pitem, coalesced );
+      ++reads;
+    }
+    double current = now();
+    if( changed ) {
+      if( !it->changed ) latencies.push_back( current - it->start );
+      it->changed = true;
+      it->stable  = 0;
+    } else if( it->changed ) {
+      ++it->stable;
+    }
+
+    if( it->changed && it->stable >= settle ) {
+      ++settled;
+      it = _follows.erase( it );
+    } else if( current >= it->until ) {
+      ++expired;
+      it = _follows.erase( it );
+    } else {
+      ++it;
+    }
+  }
+
+  _lock.lock();
+  double period = _followPeriod;
+  if( _cycleGate && _halCycle > period ) period = _halCycle;
+  _followDue = now() + period;
+  _followReads   += reads;
+  _followSettled += settled;
+  _followExpired += expired;
+  _coalesced     += coalesced;
+  std::vector< double >::const_iterator lit = latencies.begin();
+  for( ; lit != latencies.end(); ++lit ) _followLatency.add( *lit );
+  _lock.unlock();
+
+  dispatch();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Follow an item after a write
+//! @param [in]  object  Object name of the written item
+//!
+//! The written item and its related items are read with the fast-follow
+//! period until they settled. Items without records are ignored.
+//! Nothing is followed unless a FollowWindow is set.
+//------------------------------------------------------------------------------
+void isegHalThread::follow( std::string const& object ) {
+  std::vector< std::string > objects( 1, object );
+  size_t dot = object.rfind( '.' );
+  _lock.lock();
+  if( _followWindow <= 0. ) {
+    _lock.unlock();
+    return;
+  }
+  std::map< std::string, std::vector< std::string > >::const_iterator rit = _related.find( object.substr( dot + 1 ) );
+  if( rit != _related.end() ) {
+    std::vector< std::string >::const_iterator lit = rit->second.begin();
+    for( ; lit != rit->second.end(); ++lit ) objects.push_back( object.substr( 0, dot + 1 ) + *lit );
+  }
+
+  double current = now();
+  std::vector< std::string >::const_iterator oit = objects.begin();
+  for( ; oit != objects.end(); ++oit ) {
+    std::map< std::string, isegHalItem* >::const_iterator iit = _items.find( *oit );
+    if( iit == _items.end() ) continue;
+    isegHalFollow follow;
+    follow.pitem   = iit->second;
+    follow.start   = current;
+    follow.until   = current + _followWindow;
+    follow.stable  = 0;
+    follow.changed = false;
+    _followRequests.push_back( follow );
+    ++_followed;
+  }
+  // _follows is owned by the polling thread, only move the deadline forward
+  if( _followDue > current + _followPeriod ) _followDue = current + _followPeriod;
+  _lock.unlock();
+
+  _wakeup.signal();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Set the window in which items are followed after a write
+//! @param [in]  val  Window in seconds, 0 disables the fast-follow
+//------------------------------------------------------------------------------
+void isegHalThread::setFollowWindow( double val ) {
+  _lock.lock();
+  _followWindow = val;
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Set the period of reading the followed items
+//! @param [in]  val  Period in seconds, values not greater than 0 are ignored
+//------------------------------------------------------------------------------
+void isegHalThread::setFollowPeriod( double val ) {
+  // a period of 0 would make the polling thread spin on the followed items
+  if( !( val > 0. ) ) return;
+  _lock.lock();
+  _followPeriod = val;
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Set the number of unchanged reads after which an item settled
+//! @param [in]  val  Number of reads
+//------------------------------------------------------------------------------
+void isegHalThread::setFollowSettle( unsigned val ) {
+  _lock.lock();
+  _followSettle = val;
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Set the items followed together with a written item
+//! @param [in]  leaf     Leaf name of the written item, e.g. "VoltageSet"
+//! @param [in]  related  Leaf names of the related items of the same channel
+//!                       or module, separated by spaces, commas or semicolons
+//------------------------------------------------------------------------------
+void isegHalThread::setRelated( std::string const& leaf, std::string const& related ) {
+  std::vector< std::string > leaves = splitFrames( related.c_str() );
+  _lock.lock();
+  if( leaves.empty() ) _related.erase( leaf );
+  else _related[leaf] = leaves;
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Dispatch pending updates to the records
+//!
+//! Issues one scanIoRequest per pending scan group and one callback per
+//! pending readback, or queues them to the lane of this interface if the
+//! isegHAL worker pool is used. A group stays pending while its previous scan request
+//! is in flight or if its request could not be queued for all priorities.
+//! A readback stays pending if the callback queue is full.
+//! Thus bursts of changes result in additional latency, but no update is
+//! lost, and the pending set is bounded by the number of groups and records.
+//------------------------------------------------------------------------------
+void isegHalThread::dispatch() {
+  unsigned long requests  = 0;
+  unsigned long readbacks = 0;
+  unsigned long deferred  = 0;
+  isegHalWorker* pworker  = isegHalWorkerPool::instance().worker( _lane );
+
+  // groups which stay pending are moved to the front of the list
+  std::vector<isegHalScanGroup*>::iterator git  = _pendingGroups.begin();
+  std::vector<isegHalScanGroup*>::iterator gend = _pendingGroups.begin();
+  for( ; git != _pendingGroups.end(); ++git ) {
+    isegHalScanGroup* pgroup = *git;
+    if( epicsAtomicGetIntT( &pgroup->inFlight ) <= 0 ) {
+      unsigned expected = 0;
+      int nexpected = 0;
+      _lock.lock();
+      for( int prio = 0; prio < NUM_CALLBACK_PRIORITIES; ++prio ) {
+        if( pgroup->records[prio] ) {
+          expected |= ( 1u << prio );
+          ++nexpected;
+        }
+      }
+      _lock.unlock();
+
+      // set before the request, the scans might complete immediately
+      epicsAtomicSetIntT( &pgroup->inFlight, nexpected );
+      unsigned queued = 0;
+      if( nexpected ) {
+        if( pworker ) queued = pworker->request( pgroup, expected ) ? expected : 0;
+        else          queued = scanIoRequest( pgroup->ioscanpvt ) & expected;
+      }
+      int nqueued = 0;
+      for( int prio = 0; prio < NUM_CALLBACK_PRIORITIES; ++prio ) {
+        if( queued & ( 1u << prio ) ) ++nqueued;
+      }
+      if( nqueued < nexpected ) epicsAtomicAddIntT( &pgroup->inFlight, nqueued - nexpected );
+
+      if( queued == expected ) {
+        epicsAtomicSetIntT( &pgroup->pending, 0 );
+        pgroup->deferred = false;
+        if( nexpected ) ++requests;
+        continue;
+      }
+    }
+    pgroup->deferred = true;
+    ++deferred;
+    *gend++ = pgroup;
+  }
+  _pendingGroups.erase( gend, _pendingGroups.end() );
+
+  std::vector<devIsegHal_info_t*>::iterator rit  = _pendingReadbacks.begin();
+  std::vector<devIsegHal_info_t*>::iterator rend = _pendingReadbacks.begin();
+  for( ; rit != _pendingReadbacks.end(); ++rit ) {
+    // readback already discarded by a put
+    if( 0 == epicsAtomicGetIntT( &(*rit)->readback ) ) {
+      (*rit)->pending = false;
+      continue;
+    }
+    callbackSetPriority( (*rit)->prec->prio, &(*rit)->readbackCallback );
+    if( pworker ? pworker->request( *rit ) : ( 0 == callbackRequest( &(*rit)->readbackCallback ) ) ) {
+      (*rit)->pending = false;
+      ++readbacks;
+      continue;
+    }
+    ++deferred;
+    *rend++ = *rit;
+  }
+  _pendingReadbacks.erase( rend, _pendingReadbacks.end() );
+
+  _lock.lock();
+  _scanRequests += requests;
+  _readbacks    += readbacks;
+  _deferred     += deferred;
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Check if isegHAL collected new data
+//! @param [in]  pclass  Address of the poll class
+//! @return      false if the poll of this class can be skipped
+//!
+//! Reads the CycleCounter of the interface and compares it to the value at
+//! the previous poll of this class. The advance of the counter is also
+//! used to estimate the cycle period of isegHAL.
+//! If the CycleCounter cannot be read, the poll class is always polled.
+//------------------------------------------------------------------------------
+bool isegHalThread::halCycleAdvanced( isegHalPollClass* pclass ) {
+  if( !_cycleGate ) return true;
+
+  epicsUInt32 counter = 0;
+  IsegItem item = iseg_getItem( _interface.c_str(), "CycleCounter" );
+  if(    strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0
+      || devIsegHalParseUInt32( item.value, &counter ) != OK ) return true;
+
+  double current = now();
+  if( !_cycleCounterValid || counter != _lastCycleCounter ) {
+    if( _cycleCounterValid ) {
+      // unsigned difference also handles an overflow of the counter
+      double period = ( current - _lastCycleTime ) / (epicsUInt32)( counter - _lastCycleCounter );
+      _lock.lock();
+      _halCycle = ( _halCycle > 0. ) ? 0.8 * _halCycle + 0.2 * period : period;
+      _lock.unlock();
+    }
+    _lastCycleCounter  = counter;
+    _lastCycleTime     = current;
+    _cycleCounterValid = true;
+  }
+
+  bool advanced = ( !pclass->cycleCounterValid || counter != pclass->lastCycleCounter );
+  pclass->lastCycleCounter  = counter;
+  pclass->cycleCounterValid = true;
+  if( !advanced ) {
+    _lock.lock();
+    ++pclass->unchanged;
+    ++_unchanged;
+    _lock.unlock();
+    if( 3 <= _debug )
+      printf( "isegHalThread(%s)::run: CycleCounter %u unchanged, skipping class '%s'\n",
+              _interface.c_str(), counter, pclass->name.c_str() );
+  }
+  return advanced;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Check the registers of a module
+//! @param [in]  pclass  Address of the poll class
+//! @param [in]  module  Module ("line.module") to check
+//! @return      true if the channel items of this module have to be read
+//!
+//! The EventStatus and Status of the module are read at most once per
+//! cycle of the poll class and compared to the values of the previous
+//! check. If the registers cannot be read, the channels are read as well.
+//------------------------------------------------------------------------------
+bool isegHalThread::moduleActive( isegHalPollClass* pclass, std::string const& module ) {
+  std::map< std::string, isegHalModuleGate >::iterator it = pclass->modules.find( module );
+  if( it == pclass->modules.end() ) {
+    isegHalModuleGate gate;
+    gate.eventStatus     = module + ".EventStatus";
+    gate.status          = module + ".Status";
+    gate.lastEventStatus = 0;
+    gate.lastStatus      = 0;
+    gate.valid           = false;
+    gate.active          = true;
+    gate.cycle           = 0;
+    it = pclass->modules.insert( std::make_pair( module, gate ) ).first;
+  } else if( it->second.cycle == pclass->cycles ) {
+    return it->second.active;
+  }
+  isegHalModuleGate& gate = it->second;
+  gate.cycle = pclass->cycles;
+
+  epicsUInt32 eventStatus = 0;
+  epicsUInt32 status = 0;
+  IsegItem item = iseg_getItem( _interface.c_str(), gate.eventStatus.c_str() );
+  bool ok = ( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) == 0
+              && devIsegHalParseUInt32( item.value, &eventStatus ) == OK );
+  if( ok ) {
+    item = iseg_getItem( _interface.c_str(), gate.status.c_str() );
+    ok = ( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) == 0
+           && devIsegHalParseUInt32( item.value, &status ) == OK );
+  }
+  if( !ok ) {
+    gate.valid  = false;
+    gate.active = true;
+    return true;
+  }
+
+  gate.active = ( !gate.valid || eventStatus != gate.lastEventStatus || status != gate.lastStatus );
+  gate.valid           = true;
+  gate.lastEventStatus = eventStatus;
+  gate.lastStatus      = status;
+
+  if( 2 <= _debug && gate.active )
+    printf( "isegHalThread(%s)::run: Module '%s' changed: EventStatus %u, Status %u\n",
+            _interface.c_str(), module.c_str(), eventStatus, status );
+  return gate.active;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get a poll class
+//! @param [in]  name  Name of the poll class
+//! @return      Address of the poll class, NULL if it does not exist
+//!
+//! Poll classes are predefined or created by changeIntervall, i.e. by
+//! devIsegHalSetOpt( PORT, "Intervall:<PollClass>", PERIOD ), so a typo
+//! in the poll class of a record is not silently polled as a new class.
+//------------------------------------------------------------------------------
+isegHalPollClass* isegHalThread::pollClass( std::string const& name ) {
+  _lock.lock();
+  std::map< std::string, isegHalPollClass* >::iterator it = _classes.find( name );
+  isegHalPollClass* pclass = ( it != _classes.end() ) ? it->second : NULL;
+  _lock.unlock();
+  return pclass;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Change the period of a poll class
+//! @param [in]  name  Name of the poll class
+//! @param [in]  val   New period in seconds, must be positive
+//!
+//! If the poll class does not exist yet, it is created.
+//! The poll class is rescheduled with the new period.
+//------------------------------------------------------------------------------
+void isegHalThread::changeIntervall( std::string const& name, double val ) {
+  _lock.lock();
+  std::map< std::string, isegHalPollClass* >::iterator it = _classes.find( name );
+  if( it == _classes.end() ) {
+    isegHalPollClass* pclass = new isegHalPollClass;
+    pclass->name     = name;
+    pclass->cycles    = 0;
+    pclass->overruns  = 0;
+    pclass->reads     = 0;
+    pclass->skipped   = 0;
+    pclass->unchanged = 0;
+    pclass->lastSweep = -1.;
+    pclass->lastCycleCounter  = 0;
+    pclass->cycleCounterValid = false;
+    it = _classes.insert( std::make_pair( name, pclass ) ).first;
+  }
+  it->second->period = val;
+  it->second->due    = now() + val;
+  _schedule.push( deadline_t( it->second->due, it->second ) );
+  _lock.unlock();
+
+  _wakeup.signal();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the shared item of a record
+//! @param [in]  pinfo  Address of the record's private data structure
+//! @return      Address of the item
+//!
+//! All records using the same object of this interface share one item.
+//! If no item exists yet for this object, it is created with the
+//! current value of the record.
+//------------------------------------------------------------------------------
+isegHalItem* isegHalThread::item( const devIsegHal_info_t* pinfo ) {
+  isegHalScanGroup* pgroup = scanGroup( pinfo->object );
+  _lock.lock();
+  std::map< std::string, isegHalItem* >::iterator it = _items.find( pinfo->object );
+  if( it == _items.end() ) {
+    isegHalItem* pitem = new isegHalItem;
+    memcpy( pitem->object, pinfo->object, FULLY_QUALIFIED_OBJECT_SIZE );
+    memcpy( pitem->interface, pinfo->interface, 20 );
+    pitem->slot.seq   = 0;
+    memcpy( &pitem->slot.value, &pinfo->value, sizeof( devIsegHal_value_t ) );
+    pitem->slot.time  = pinfo->time;
+    pitem->stale      = pinfo->stale;
+    pitem->pollIndex = -1;
+    pitem->pclass    = NULL;
+    pitem->pgroup    = pgroup;
+    // channel items are named "line.module.channel.item"
+    std::string object( pinfo->object );
+    size_t dot = object.find( '.', object.find( '.' ) + 1 );
+    if( std::count( object.begin(), object.end(), '.' ) == 3 ) pitem->module = object.substr( 0, dot );
+    it = _items.insert( std::make_pair( std::string( pinfo->object ), pitem ) ).first;
+  }
+  _lock.unlock();
+  return it->second;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the I/O Intr scan group of an item
+//! @param [in]  object  Object name of the item
+//! @return      Address of the scan group
+//!
+//! Items of a module ("line.module.*") share the scan group of the module,
+//! all other items share the scan group of the interface.
+//------------------------------------------------------------------------------
+isegHalScanGroup* isegHalThread::scanGroup( std::string const& object ) {
+  std::string name;
+  size_t dot = object.find( '.' );
+  if( dot != std::string::npos ) dot = object.find( '.', dot + 1 );
+  if( dot != std::string::npos ) name = object.substr( 0, dot );
+
+  _lock.lock();
+  std::map< std::string, isegHalScanGroup* >::iterator it = _groups.find( name );
+  if( it == _groups.end() ) {
+    isegHalScanGroup* pgroup = new isegHalScanGroup;
+    pgroup->name     = name;
+    pgroup->pthread  = this;
+    pgroup->inFlight = 0;
+    pgroup->pending  = 0;
+    pgroup->deferred = false;
+    for( int prio = 0; prio < NUM_CALLBACK_PRIORITIES; ++prio ) pgroup->records[prio] = 0;
+    scanIoInit( &pgroup->ioscanpvt );
+    scanIoSetComplete( pgroup->ioscanpvt, scanGroupComplete, pgroup );
+    it = _groups.insert( std::make_pair( name, pgroup ) ).first;
+  }
+  _lock.unlock();
+  return it->second;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the last values of all items of this interface
+//! @param [out] values  Values for the snapshot file
+//!
+//! Items whose value was never confirmed by isegHAL are skipped.
+//------------------------------------------------------------------------------
+void isegHalThread::snapshot( std::vector< isegHalSnapshotValue >& values ) const {
+  _lock.lock();
+  std::map< std::string, isegHalItem* >::const_iterator it = _items.begin();
+  for( ; it != _items.end(); ++it ) {
+    if( it->second->stale ) continue;
+    devIsegHal_value_t value;
+    isegHalSnapshotValue entry;
+    memset( &entry, 0, sizeof( entry ) );
+    it->second->slot.load( &value, &entry.time );
+    if( !value.valid ) continue;
+    memcpy( entry.interface, it->second->interface, sizeof( entry.interface ) );
+    memcpy( entry.object, it->second->object, FULLY_QUALIFIED_OBJECT_SIZE );
+    memcpy( entry.value, value.str, VALUE_SIZE );
+    values.push_back( entry );
+  }
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Add a record to the list
+//! @param [in]  prec  Address of the record to be added
+//!
+//! Registers a new record to be checked by the thread.
+//! The record subscribes to its item, which is polled with the fastest
+//! poll class of all its records. Array records subscribe their elements.
+//------------------------------------------------------------------------------
+void isegHalThread::registerInterrupt( dbCommon* prec, devIsegHal_info_t *pinfo ) {
+  if( !pinfo->pclass ) pinfo->pclass = pollClass( "default" );
+  if( pinfo->parray ) {
+    // elements of output records are subscribed at initialization
+    isegHalArray* parray = static_cast< isegHalArray* >( pinfo->parray );
+    if( !pinfo->output ) {
+      std::vector< devIsegHal_info_t* >::const_iterator it = parray->elements.begin();
+      for( ; it != parray->elements.end(); ++it ) registerInterrupt( prec, *it );
+    }
+    _lock.lock();
+    if( !pinfo->output && prec->prio < NUM_CALLBACK_PRIORITIES ) ++parray->pgroup->records[prec->prio];
+    _lock.unlock();
+    return;
+  }
+  if( !pinfo->pitem ) return;
+  isegHalPollClass* pclass = static_cast< isegHalPollClass* >( pinfo->pclass );
+  isegHalItem* pitem = static_cast< isegHalItem* >( pinfo->pitem );
+
+  // each record is only added once
+  if( !pitem->subscribers.add( pinfo ) ) return;
+
+  _lock.lock();
+  if( !pinfo->output && !pinfo->pparent && prec->prio < NUM_CALLBACK_PRIORITIES ) ++pitem->pgroup->records[prec->prio];
+  if( !pitem->pclass || pclass->period < pitem->pclass->period ) {
+    if( pitem->pclass ) pitem->pclass->items.remove( pitem );
+    pitem->pclass = pclass;
+    pclass->items.add( pitem );
+  }
+  _lock.unlock();
+
+  if( 1 <= _debug )
+    printf( "isegHalThread(%s): Register new record '%s' for item '%s' in class '%s'\n",
+            _interface.c_str(), prec->name, pitem->object, pitem->pclass->name.c_str() );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Remove a record to the list
+//! @param [in]  pinfo  Address of the record's private data structure
+//!
+//! Removes a record from the list which is checked by the thread for updates.
+//! If no other record uses its item, the item is no longer polled, otherwise
+//! it is moved to the fastest poll class of the remaining records.
+//! Array records unsubscribe their elements.
+//------------------------------------------------------------------------------
+void isegHalThread::cancelInterrupt( devIsegHal_info_t* pinfo ) {
+  if( pinfo->parray ) {
+    isegHalArray* parray = static_cast< isegHalArray* >( pinfo->parray );
+    if( !pinfo->output ) {
+      std::vector< devIsegHal_info_t* >::const_iterator it = parray->elements.begin();
+      for( ; it != parray->elements.end(); ++it ) cancelInterrupt( *it );
+    }
+    unsigned prio = pinfo->prec->prio;
+    _lock.lock();
+    if( !pinfo->output && prio < NUM_CALLBACK_PRIORITIES && parray->pgroup->records[prio] ) {
+      --parray->pgroup->records[prio];
+    }
+    _lock.unlock();
+    return;
+  }
+  if( !pinfo->pitem ) return;
+  isegHalItem* pitem = static_cast< isegHalItem* >( pinfo->pitem );
+  if( !pitem->subscribers.remove( pinfo ) ) return;
+
+  _lock.lock();
+  unsigned prio = pinfo->prec->prio;
+  if( !pinfo->output && !pinfo->pparent && prio < NUM_CALLBACK_PRIORITIES && pitem->pgroup->records[prio] ) {
+    --pitem->pgroup->records[prio];
+  }
+  isegHalPollClass* pfastest = NULL;
+  std::vector< devIsegHal_info_t* > subscribers = pitem->subscribers.entries();
+  std::vector< devIsegHal_info_t* >::const_iterator it = subscribers.begin();
+  for( ; it != subscribers.end(); ++it ) {
+    isegHalPollClass* pclass = static_cast< isegHalPollClass* >( (*it)->pclass );
+    if( pclass && ( !pfastest || pclass->period < pfastest->period ) ) pfastest = pclass;
+  }
+  bool moved = ( pfastest != pitem->pclass );
+  if( moved ) {
+    if( pitem->pclass ) pitem->pclass->items.remove( pitem );
+    pitem->pclass = pfastest;
+    if( pfastest ) pfastest->items.add( pitem );
+  }
+  _lock.unlock();
+
+  if( 1 <= _debug && moved && pfastest )
+    printf( "isegHalThread(%s): Item '%s' polled in class '%s'\n",
+            _interface.c_str(), pitem->object, pfastest->name.c_str() );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Send broadcast frames within one pause of the data collector
+//! @param [in]  frames   Raw frames to send, e.g. "004#e800600100%02x"
+//! @param [out] latency  Time from pausing to restarting the data collector
+//! @return      ERROR if a frame could not be sent, otherwise OK
+//!
+//! The data collector of isegHAL is paused once ("Configuration" = 1),
+//! all frames are written and the collector is restarted. Polling is
+//! disabled meanwhile. Broadcasts of an interface are serialized.
+//------------------------------------------------------------------------------
+long isegHalThread::broadcast( std::vector< std::string > const& frames, double& latency ) {
+  _broadcastLock.lock();
+  double start = now();
+  disable();
+
+  long status = OK;
+  unsigned long sent = 0;
+  if( pauseCollector() != OK ) {
+    fprintf( stderr, "\033[31;1misegHalThread(%s): Error while stopping data collector for sending broadcast.\033[0m\n",
+             _interface.c_str() );
+    status = ERROR;
+  }
+  std::vector< std::string >::const_iterator it = frames.begin();
+  for( ; it != frames.end() && OK == status; ++it ) {
+    if( iseg_setItem( _interface.c_str(), "Write", it->c_str() ) != ISEG_OK ) {
+      fprintf( stderr, "\033[31;1misegHalThread(%s): Error while sending broadcast command '%s'.\033[0m\n",
+               _interface.c_str(), it->c_str() );
+      status = ERROR;
+      break;
+    }
+    ++sent;
+  }
+  // always restart the data collector
+  if( resumeCollector() != OK ) {
+    fprintf( stderr, "\033[31;1misegHalThread(%s): Error while starting data collector after sending broadcast.\033[0m\n",
+             _interface.c_str() );
+    status = ERROR;
+  }
+
+  enable();
+  latency = now() - start;
+
+  _lock.lock();
+  ++_broadcasts;
+  _broadcastFrames += sent;
+  if( ERROR == status ) ++_broadcastErrors;
+  _broadcastTime.add( latency );
+  _lock.unlock();
+  _broadcastLock.unlock();
+  return status;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Send an emergency off frame
+//! @param [in]  frame      Prebuilt raw frame
+//! @param [in]  requested  Time of the request on the monotonic clock
+//! @return      ERROR if the frame could not be sent, otherwise OK
+//!
+//! Unlike broadcast() the polling thread is not disabled and the frame
+//! does not wait for a running batch of broadcasts. Like a broadcast the
+//! frame is written while the data collector is paused, using the pause
+//! shared with the broadcasts. The frame is written even if the collector
+//! could not be paused, and the collector is always restarted, unless a
+//! batch still holds it paused.
+//! The latency from the request to sending the frame and to the return
+//! of the write to isegHAL is recorded. The return of the write is not a
+//! confirmation that the modules have switched off.
+//------------------------------------------------------------------------------
+long isegHalThread::emergency( std::string const& frame, epicsUInt64 requested ) {
+  epicsTimeStamp time;
+  epicsTimeGetCurrent( &time );
+
+  long status = OK;
+  bool pauseFailed = false;
+  epicsUInt64 written = 0;
+  if( pauseCollector() != OK ) {
+    fprintf( stderr, "\033[31;1misegHalThread(%s): Error while stopping data collector for emergency off.\033[0m\n",
+             _interface.c_str() );
+    pauseFailed = true;
+  }
+  // the frame is sent in any case, an emergency off must not be dropped
+  epicsUInt64 sent = epicsMonotonicGet();
+  if( iseg_setItem( _interface.c_str(), "Write", frame.c_str() ) != ISEG_OK ) {
+    fprintf( stderr, "\033[31;1misegHalThread(%s): Error while sending emergency off '%s'.\033[0m\n",
+             _interface.c_str(), frame.c_str() );
+    status = ERROR;
+  } else {
+    written = epicsMonotonicGet();
+  }
+  // always restart the data collector
+  if( resumeCollector() != OK ) {
+    fprintf( stderr, "\033[31;1misegHalThread(%s): Error while starting data collector after emergency off.\033[0m\n",
+             _interface.c_str() );
+    status = ERROR;
+  }
+
+  _lock.lock();
+  ++_emergencies;
+  _emergencyTime = time;
+  if( pauseFailed ) ++_emergencyPauseErrors;
+  if( ERROR == status ) ++_emergencyErrors;
+  if( written ) {
+    _emergencySend.add( ( sent - requested ) * 1e-9 );
+    _emergencyWritten.add( ( written - requested ) * 1e-9 );
+  }
+  _lock.unlock();
+  return status;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Pause the data collector of isegHAL
+//! @return      ERROR if the collector could not be paused, otherwise OK
+//!
+//! Broadcasts and emergency offs share the pause: only the first of them
+//! stops the collector and only the last one restarts it. Each call must
+//! be followed by resumeCollector(), even if it failed.
+//------------------------------------------------------------------------------
+long isegHalThread::pauseCollector() {
+  long status = OK;
+  _collectorLock.lock();
+  if( 0 == _paused++ && iseg_setItem( _interface.c_str(), "Configuration", "1" ) != ISEG_OK ) status = ERROR;
+  _collectorLock.unlock();
+  return status;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Restart the data collector of isegHAL
+//! @return      ERROR if the collector could not be restarted, otherwise OK
+//------------------------------------------------------------------------------
+long isegHalThread::resumeCollector() {
+  long status = OK;
+  _collectorLock.lock();
+  if( 0 == --_paused && iseg_setItem( _interface.c_str(), "Configuration", "0" ) != ISEG_OK ) status = ERROR;
+  _collectorLock.unlock();
+  return status;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Print statistics of the polling thread
+//! @param [in]  level   Level of detail
+//------------------------------------------------------------------------------
+void isegHalThread::report( int level ) const {
+  printf( "  Polling thread: %s, debug level %u, lane %u\n",
+          _run ? "enabled" : "disabled", _debug, _lane );
+
+  _lock.lock();
+  printf( "    %lu cycles, last cycle %.6lf s, max %.6lf s, %lu overruns\n",
+          _cycleTime.count(), _cycleTime.last(), _cycleTime.max(), _overruns );
+  if( _cycleGate ) {
+    printf( "    isegHAL cycle %.3lf s, %lu polls skipped with unchanged CycleCounter\n",
+            _halCycle, _unchanged );
+  }
+  if( _hierarchical ) {
+    printf( "    Hierarchical polling, full sweep every %.3lf s: %lu items read, %lu skipped\n",
+            _fullSweep, _reads, _skipped );
+  }
+  if( _initFetched || _initFailed ) {
+    printf( "    %s initialization: %lu initial values fetched after iocInit in %.3lf s, %lu failed\n",
+            _deferInit ? "Deferred" : "Snapshot", _initFetched, _initFetchTime, _initFailed );
+  }
+  if( _broadcasts ) {
+    printf( "    %lu broadcasts with %lu frames, %lu errors, last %.6lf s, max %.6lf s\n",
+            _broadcasts, _broadcastFrames, _broadcastErrors, _broadcastTime.last(), _broadcastTime.max() );
+  }
+  if( _emergencies ) {
+    char time[40];
+    epicsTimeToStrftime( time, sizeof( time ), "%Y-%m-%d %H:%M:%S.%06f", &_emergencyTime );
+    printf( "    %lu emergency offs, %lu errors, last at %s: sent after %.6lf s, written after %.6lf s\n",
+            _emergencies, _emergencyErrors, time, _emergencySend.last(), _emergencyWritten.last() );
+    printf( "      worst case: sent after %.6lf s, written after %.6lf s\n",
+            _emergencySend.max(), _emergencyWritten.max() );
+    if( _emergencyPauseErrors ) {
+      printf( "      %lu sent without pause of the data collector\n", _emergencyPauseErrors );
+    }
+  }
+  if( _followWindow > 0. ) {
+    printf( "    Fast-follow every %.3lf s for %.3lf s: %lu items followed, %lu reads, %lu settled, %lu expired\n",
+            _followPeriod, _followWindow, _followed, _followReads, _followSettled, _followExpired );
+    if( _followLatency.count() ) {
+      printf( "      readback after write: last %.6lf s, mean %.6lf s, max %.6lf s\n",
+              _followLatency.last(), _followLatency.mean(), _followLatency.max() );
+    }
+  }
+  if( level > 1 ) {
+    _cycleTime.report( "Cycle duration" );
+    _jitter.report( "Wake-up jitter" );
+    if( _followLatency.count() ) _followLatency.report( "Readback after write" );
+    if( _broadcasts ) _broadcastTime.report( "Broadcast latency" );
+    if( _emergencies ) {
+      _emergencySend.report( "Emergency off, request to send" );
+      _emergencyWritten.report( "Emergency off, request to write return" );
+    }
+  }
+
+  unsigned long nitems = 0;
+  unsigned long nrecs  = 0;
+  std::map< std::string, isegHalPollClass* >::const_iterator it = _classes.begin();
+  for( ; it != _classes.end(); ++it ) {
+    std::vector<isegHalItem*> items = it->second->items.entries();
+    unsigned long nclassrecs = 0;
+    std::vector<isegHalItem*>::const_iterator iit = items.begin();
+    for( ; iit != items.end(); ++iit ) nclassrecs += (*iit)->subscribers.size();
+    nitems += items.size();
+    nrecs  += nclassrecs;
+
+    printf( "    Poll class '%s': intervall %.3lf s, %lu items for %lu records, %lu cycles, %lu overruns, %lu unchanged\n",
+            it->first.c_str(), it->second->period, (unsigned long)items.size(), nclassrecs,
+            it->second->cycles, it->second->overruns, it->second->unchanged );
+    if( _hierarchical ) {
+      printf( "      %lu modules gated, %lu items read, %lu skipped\n",
+              (unsigned long)it->second->modules.size(), it->second->reads, it->second->skipped );
+    }
+    if( level > 2 ) {
+      for( iit = items.begin(); iit != items.end(); ++iit )
+        printf( "      %s (%lu records)\n", (*iit)->object, (unsigned long)(*iit)->subscribers.size() );
+    }
+  }
+  printf( "    %lu records polled via %lu items, dedup ratio %.2lf\n",
+          nrecs, nitems, nitems ? (double)nrecs / nitems : 0. );
+  printf( "    %lu I/O Intr scan groups, %lu scan requests, %lu readbacks, %lu coalesced, %lu deferred\n",
+          (unsigned long)_groups.size(), _scanRequests, _readbacks, _coalesced, _deferred );
+  _lock.unlock();
+
+  writer.report( level );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get statistics of the polling thread
+//! @param [in]  name   Name of the statistic
+//! @param [out] value  Current value of the statistic
+//! @return      false if the statistic is unknown, otherwise true
+//!
+//! Possible statistics are:
+//! Cycles, CycleTime, CycleTimeMax, CycleTimeMean,
+//! Jitter, JitterMax, JitterMean, Overruns, Reads, Skipped,
+//! Unchanged, HalCycle, Coalesced, Deferred, Broadcasts,
+//! BroadcastTime, BroadcastTimeMax, BroadcastTimeMean, Emergencies,
+//! EmergencySend, EmergencySendMax, EmergencyWritten, EmergencyWrittenMax,
+//! EmergencyPauseErrors,
+//! Followed, FollowReads, FollowSettled, FollowExpired,
+//! FollowLatency, FollowLatencyMax, FollowLatencyMean,
+//! and the statistics of the writer thread
+//------------------------------------------------------------------------------
+bool isegHalThread::statistic( std::string const& name, double& value ) const {
+  bool found = true;
+  _lock.lock();
+  if(      "Cycles"        == name ) value = _cycleTime.count();
+  else if( "CycleTime"     == name ) value = _cycleTime.last();
+  else if( "CycleTimeMax"  == name ) value = _cycleTime.max();
+  else if( "CycleTimeMean" == name ) value = _cycleTime.mean();
+  else if( "Jitter"        == name ) value = _jitter.last();
+  else if( "JitterMax"     == name ) value = _jitter.max();
+  else if( "JitterMean"    == name ) value = _jitter.mean();
+  else if( "Overruns"      == name ) value = _overruns;
+  else if( "Reads"         == name ) value = _reads;
+  else if( "Skipped"       == name ) value = _skipped;
+  else if( "Unchanged"     == name ) value = _unchanged;
+  else if( "HalCycle"      == name ) value = _halCycle;
+  else if( "Coalesced"     == name ) value = _coalesced;
+  else if( "Deferred"      == name ) value = _deferred;
+  else if( "Broadcasts"    == name ) value = _broadcasts;
+  else if( "BroadcastTime" == name ) value = _broadcastTime.last();
+  else if( "BroadcastTimeMax"  == name ) value = _broadcastTime.max();
+  else if( "BroadcastTimeMean" == name ) value = _broadcastTime.mean();
+  else if( "Emergencies"   == name ) value = _emergencies;
+  else if( "EmergencySend" == name ) value = _emergencySend.last();
+  else if( "EmergencySendMax"    == name ) value = _emergencySend.max();
+  else if( "EmergencyWritten"    == name ) value = _emergencyWritten.last();
+  else if( "EmergencyWrittenMax" == name ) value = _emergencyWritten.max();
+  else if( "EmergencyPauseErrors" == name ) value = _emergencyPauseErrors;
+  else if( "Followed"      == name ) value = _followed;
+  else if( "FollowReads"   == name ) value = _followReads;
+  else if( "FollowSettled" == name ) value = _followSettled;
+  else if( "FollowExpired" == name ) value = _followExpired;
+  else if( "InitFetched"   == name ) value = _initFetched;
+  else if( "InitFetchTime" == name ) value = _initFetchTime;
+  else if( "FollowLatency" == name ) value = _followLatency.last();
+  else if( "FollowLatencyMax"  == name ) value = _followLatency.max();
+  else if( "FollowLatencyMean" == name ) value = _followLatency.mean();
+  else found = false;
+  _lock.unlock();
+  if( !found ) found = writer.statistic( name, value );
+  return found;
+}
+
+// Configuration routines.  Called from the iocsh function below 
+extern "C" {
+
+  static const iocshArg isegConnectArg0 = { "port", iocshArgString };
+  static const iocshArg isegConnectArg1 = { "tty",  iocshArgString };
+  static const iocshArg isegConnectArg2 = { "timeout", iocshArgDouble };
+  static const iocshArg * const isegConnectArgs[] = { &isegConnectArg0, &isegConnectArg1, &isegConnectArg2 };
+  static const iocshFuncDef isegConnectFuncDef = { "isegHalConnect", 3, isegConnectArgs };
+
+  //----------------------------------------------------------------------------
+  //! @brief       iocsh callable function to connect to isegHalServer
+  //!
+  //! This function can be called from the iocsh via "isegHalConnect( PORT, TTY, TIMEOUT )"
+  //! PORT is the deviseg internal name of the interface which is also used inside
+  //! the records.
+  //! TTY is the name of the hardware interface (e.g. "can0").
+  //! TIMEOUT is the optional maximum time in seconds to wait until isegHAL
+  //! has collected the data of the interface (default 30).
+  //----------------------------------------------------------------------------
+  static void isegConnectCallFunc( const iocshArgBuf *args ) {
+    std::cout << "using HAL version [" << iseg_getVersionString() << "]" << std::endl;
+    if( !isegHalConnectionHandler::instance().connect( args[0].sval, args[1].sval, args[2].dval ) ){
+      fprintf( stderr, "\033[31;1mCannot connect to isegHAL interface %s(%s)\033[0m\n", args[0].sval, args[1].sval );
+    }
+  }
+
+  static const iocshArg isegConnectAllArg0 = { "interfaces", iocshArgString };
+  static const iocshArg isegConnectAllArg1 = { "timeout", iocshArgDouble };
+  static const iocshArg * const isegConnectAllArgs[] = { &isegConnectAllArg0, &isegConnectAllArg1 };
+  static const iocshFuncDef isegConnectAllFuncDef = { "isegHalConnectAll", 2, isegConnectAllArgs };
+
+  //----------------------------------------------------------------------------
+  //! @brief       iocsh callable function to connect to several interfaces concurrently
+  //!
+  //! This function can be called from the iocsh via "isegHalConnectAll( INTERFACES, TIMEOUT )"
+  //! INTERFACES is a list of PORT=TTY pairs, separated by spaces, commas or semicolons.
+  //! TIMEOUT is the optional maximum time in seconds to wait until isegHAL
+  //! has collected the data of the interfaces (default 30).
+  //----------------------------------------------------------------------------
+  static void isegConnectAllCallFunc( const iocshArgBuf *args ) {
+    if( !args[0].sval ) {
+      fprintf( stderr, "\033[31;1mUsage: isegHalConnectAll( \"PORT1=TTY1 PORT2=TTY2 ...\", TIMEOUT )\033[0m\n" );
+      return;
+    }
+    std::vector< std::pair< std::string, std::string > > interfaces;
+    std::vector< std::string > pairs = splitFrames( args[0].sval );
+    std::vector< std::string >::const_iterator it = pairs.begin();
+    for( ; it != pairs.end(); ++it ) {
+      size_t eq = it->find( '=' );
+      if( eq == std::string::npos || eq == 0 || eq + 1 == it->size() ) {
+        fprintf( stderr, "\033[31;1mInvalid interface '%s', expected PORT=TTY\033[0m\n", it->c_str() );
+        return;
+      }
+      interfaces.push_back( std::make_pair( it->substr( 0, eq ), it->substr( eq + 1 ) ) );
+    }
+    std::cout << "using HAL version [" << iseg_getVersionString() << "]" << std::endl;
+    if( !isegHalConnectionHandler::instance().connectAll( interfaces, args[1].dval ) ) {
+      fprintf( stderr, "\033[31;1mCannot connect to all isegHAL interfaces\033[0m\n" );
+    }
+  }
+
+  static const iocshArg snapshotArg0 = { "file",   iocshArgString };
+  static const iocshArg snapshotArg1 = { "period", iocshArgDouble };
+  static const iocshArg * const snapshotArgs[] = { &snapshotArg0, &snapshotArg1 };
+  static const iocshFuncDef snapshotFuncDef = { "isegHalSnapshot", 2, snapshotArgs };
+
+  //----------------------------------------------------------------------------
+  //! @brief       iocsh callable function to use a snapshot file
+  //!
+  //! This function can be called from the iocsh via "isegHalSnapshot( FILE, PERIOD )"
+  //! FILE is the path of the snapshot file, which is loaded if it exists.
+  //! PERIOD is the period in seconds of writing the snapshot after iocInit,
+  //! with 0 it is only written at exit.
+  //! Must be called before the records are loaded.
+  //----------------------------------------------------------------------------
+  static void snapshotCallFunc( const iocshArgBuf *args ) {
+    if( !args[0].sval || args[1].dval < 0. ) {
+      fprintf( stderr, "\033[31;1mUsage: isegHalSnapshot( FILE, PERIOD )\033[0m\n" );
+      return;
+    }
+    if( !isegHalSnapshot::instance().configure( args[0].sval, args[1].dval ) ) {
+      fprintf( stderr, "\033[31;1mSnapshot file already configured\033[0m\n" );
+    }
+  }
+
+  static const iocshArg parseBenchArg0 = { "loops", iocshArgInt };
+  static const iocshArg * const parseBenchArgs[] = { &parseBenchArg0 };
+  static const iocshFuncDef parseBenchFuncDef = { "isegHalParseBench", 1, parseBenchArgs };
+
+  //----------------------------------------------------------------------------
+  //! @brief       iocsh callable function to benchmark the cstring parsers
+  //!
+  //! This function can be called from the iocsh via "isegHalParseBench( LOOPS )"
+  //! LOOPS is the number of passes through the set of typical isegHAL cstrings,
+  //! if 0 a default of 100000 is used.
+  //----------------------------------------------------------------------------
+  static void parseBenchCallFunc( const iocshArgBuf *args ) {
+    devIsegHalParseBenchmark( args[0].ival > 0 ? (unsigned)args[0].ival : 0 );
+  }
+
+  static const iocshArg slotHammerArg0 = { "seconds", iocshArgDouble };
+  static const iocshArg slotHammerArg1 = { "readers", iocshArgInt };
+  static const iocshArg * const slotHammerArgs[] = { &slotHammerArg0, &slotHammerArg1 };
+  static const iocshFuncDef slotHammerFuncDef = { "isegHalSlotHammer", 2, slotHammerArgs };
+
+  //----------------------------------------------------------------------------
+  //! @brief       iocsh callable function to stress test the value slots
+  //!
+  //! This function can be called from the iocsh via "isegHalSlotHammer( SECONDS, READERS )"
+  //! One writer stores into a slot for SECONDS (default 5) while READERS threads
+  //! (default 4) load it and check that value and timestamp are consistent.
+  //----------------------------------------------------------------------------
+  static void slotHammerCallFunc( const iocshArgBuf *args ) {
+    isegHalSlot::hammer( args[0].dval > 0. ? args[0].dval : 5.,
+                         args[1].ival > 0 ? (unsigned)args[1].ival : 4 );
+  }
+
+  static const iocshArg broadcastArg0 = { "port",   iocshArgString };
+  static const iocshArg broadcastArg1 = { "frames", iocshArgString };
+  static const iocshArg * const broadcastArgs[] = { &broadcastArg0, &broadcastArg1 };
+  static const iocshFuncDef broadcastFuncDef = { "isegHalBroadcast", 2, broadcastArgs };
+
+  //----------------------------------------------------------------------------
+  //! @brief       iocsh callable function to send a batch of broadcast frames
+  //!
+  //! This function can be called from the iocsh via "isegHalBroadcast( PORT, FRAMES )"
+  //! PORT is the deviseg internal name of the interface and FRAMES the list of
+  //! raw frames, separated by spaces, commas or semicolons. All frames are sent
+  //! within one pause of the data collector of isegHAL.
+  //----------------------------------------------------------------------------
+  static void broadcastCallFunc( const iocshArgBuf *args ) {
+    if( !args[0].sval || !args[1].sval ) {
+      fprintf( stderr, "\033[31;1mUsage: isegHalBroadcast( PORT, \"FRAME1 FRAME2 ...\" )\033[0m\n" );
+      return;
+    }
+    if( !isegHalConnectionHandler::instance().connected( args[0].sval ) ) {
+      fprintf( stderr, "\033[31;1misegHal interface %s not connected!\033[0m\n", args[0].sval );
+      return;
+    }
+    std::vector< std::string > frames = splitFrames( args[1].sval );
+    if( frames.empty() ) {
+      fprintf( stderr, "\033[31;1mNo broadcast frames given\033[0m\n" );
+      return;
+    }
+    double latency = 0.;
+    isegHalThread* pthread = isegHalConnectionHandler::instance().poller( args[0].sval );
+    if( pthread->broadcast( frames, latency ) != OK ) {
+      fprintf( stderr, "\033[31;1mError while sending broadcast commands to %s\033[0m\n", args[0].sval );
+      return;
+    }
+    printf( "Sent %lu broadcast frames to %s in %.6lf s\n", (unsigned long)frames.size(), args[0].sval, latency );
+  }
+
+  static const iocshArg emergencyBenchArg0 = { "record", iocshArgString };
+  static const iocshArg emergencyBenchArg1 = { "count",  iocshArgInt };
+  static const iocshArg emergencyBenchArg2 = { "value",  iocshArgString };
+  static const iocshArg emergencyBenchArg3 = { "period", iocshArgDouble };
+  static const iocshArg * const emergencyBenchArgs[] = { &emergencyBenchArg0, &emergencyBenchArg1,
+                                                         &emergencyBenchArg2, &emergencyBenchArg3 };
+  static const iocshFuncDef emergencyBenchFuncDef = { "isegHalEmergencyBench", 4, emergencyBenchArgs };
+
+  //----------------------------------------------------------------------------
+  //! @brief       iocsh callable function to benchmark the emergency off path
+  //!
+  //! This function can be called from the iocsh via "isegHalEmergencyBench( RECORD, COUNT, VALUE, PERIOD )"
+  //! after iocInit. The prebuilt frame VALUE (0 clears, 1 sets the emergency off)
+  //! of the emergency off record RECORD is sent COUNT times (default 100), every
+  //! PERIOD seconds (default 0.01), while the interface is polled as usual.
+  //! VALUE has to be given and has to match the VAL field of the record.
+  //! The frames reach the hardware, so the command is only registered by
+  //! the registrar devIsegHalTestRegister (devIsegHalTest.dbd).
+  //----------------------------------------------------------------------------
+  static void emergencyBenchCallFunc( const iocshArgBuf *args ) {
+    const char* value = args[2].sval;
+    if(    !args[0].sval || !value || ( strcmp( value, "0" ) != 0 && strcmp( value, "1" ) != 0 )
+        || args[3].dval < 0. ) {
+      fprintf( stderr, "\033[31;1mUsage: isegHalEmergencyBench( RECORD, COUNT, VALUE(0|1), PERIOD )\033[0m\n" );
+      return;
+    }
+    emergencyBench( args[0].sval, args[1].ival > 0 ? (unsigned)args[1].ival : 100,
+                    value[0] == '1', args[3].dval > 0. ? args[3].dval : 0.01 );
+  }
+
+  static const iocshArg setWorkersArg0 = { "threads",  iocshArgInt };
+  static const iocshArg setWorkersArg1 = { "priority", iocshArgInt };
+  static const iocshArg setWorkersArg2 = { "depth",    iocshArgInt };
+  static const iocshArg * const setWorkersArgs[] = { &setWorkersArg0, &setWorkersArg1, &setWorkersArg2 };
+  static const iocshFuncDef setWorkersFuncDef = { "isegHalSetWorkers", 3, setWorkersArgs };
+
+  //----------------------------------------------------------------------------
+  //! @brief       iocsh callable function to configure the worker pool
+  //!
+  //! This function can be called from the iocsh via "isegHalSetWorkers( THREADS, PRIORITY, DEPTH )"
+  //! before iocInit.
+  //! THREADS is the number of worker threads processing the records, 0 to use the
+  //! standard EPICS scan threads instead.
+  //! PRIORITY is the EPICS priority (0-99) of the worker threads and
+  //! DEPTH the maximum number of queued jobs per worker.
+  //----------------------------------------------------------------------------
+  static void setWorkersCallFunc( const iocshArgBuf *args ) {
+    if(    args[0].ival < 0
+        || args[1].ival < epicsThreadPriorityMin || args[1].ival > epicsThreadPriorityMax
+        || args[2].ival < 1 ) {
+      fprintf( stderr, "\033[31;1mUsage: isegHalSetWorkers( THREADS, PRIORITY(0-99), DEPTH(>0) )\033[0m\n" );
+      return;
+    }
+    if( !isegHalWorkerPool::instance().configure( args[0].ival, args[1].ival, args[2].ival ) ) {
+      fprintf( stderr, "\033[31;1mWorker pool already running, call isegHalSetWorkers before iocInit\033[0m\n" );
+    }
+  }
+
+  // iocsh callable function to set options for polling thread
   static const iocshArg setOptArg0 = { "port", iocshArgString };
   static const iocshArg setOptArg1 = { "key", iocshArgString };
   static const iocshArg setOptArg2 = { "value",  iocshArgString };
@@ -732,20 +3209,43 @@ extern "C" {
   //! KEY is the name of the option and VALUE the new value for the option.
   //!
   //! Possible KEYs are:
-  //! Intervall  -  set the wait time after going through the list of records with the polling thread
+  //! Intervall  -  set the poll period of the records of the poll class "default"
+  //! Intervall:<PollClass>  -  set the poll period of the records of this poll class, creates the class if needed
   //! LogLevel   -  Change loglevel of isegHalServer
   //! debug      -  Enable debug output of polling thread
+  //! Hierarchical  -  Only read channel items of modules whose EventStatus or Status changed
+  //! FullSweep  -  set the period of the full sweeps in hierarchical mode
+  //! CycleGate  -  Skip polls if the CycleCounter of isegHAL did not advance
+  //! Lane       -  set the lane of the worker pool used by this interface
+  //! WriteWindow  -  set the window in which puts to the same item are coalesced
+  //! FollowWindow  -  set the window in which items are followed after a write
+  //! FollowPeriod  -  set the period of reading the followed items
+  //! FollowSettle  -  set the number of unchanged reads after which a followed item settled
+  //! Follow:<Item>  -  set the items followed together with a written item
+  //! DeferInit  -  read the initial values of the records once the IOC is running
   //----------------------------------------------------------------------------
   static void setOptCallFunc( const iocshArgBuf *args ) {
+    if( !args[0].sval || !args[1].sval || !args[2].sval ) {
+      fprintf( stderr, "\033[31;1mUsage: devIsegHalSetOpt( PORT, KEY, VALUE )\033[0m\n" );
+      return;
+    }
+    if( !isegHalConnectionHandler::instance().connected( args[0].sval ) ) {
+      fprintf( stderr, "\033[31;1misegHal interface %s not connected!\033[0m\n", args[0].sval );
+      return;
+    }
+    isegHalThread* pthread = isegHalConnectionHandler::instance().poller( args[0].sval );
+
     // Set new intervall for polling thread
-    if( strcmp( args[1].sval, "Intervall" ) == 0 ) {
+    if( strncmp( args[1].sval, "Intervall", 9 ) == 0
+        && ( args[1].sval[9] == 0 || args[1].sval[9] == ':' ) ) {
       double newIntervall = 0.;
       int n = sscanf( args[2].sval, "%lf", &newIntervall );
-      if( 1 != n ) {
+      if( 1 != n || newIntervall <= 0. ) {
         fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
         return;
       }
-      myIsegHalThread->changeIntervall( newIntervall );
+      const char* pollClass = ( args[1].sval[9] == ':' ) ? args[1].sval + 10 : "default";
+      pthread->changeIntervall( pollClass, newIntervall );
     }
 
     // change log level from isegHAL server
@@ -764,7 +3264,109 @@ extern "C" {
         fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
         return;
       }
-      myIsegHalThread->setDbgLvl( newDbgLvl );
+      pthread->setDbgLvl( newDbgLvl );
+    }
+
+    // Enable/disable hierarchical polling
+    if( strcmp( args[1].sval, "Hierarchical" ) == 0 ) {
+      unsigned enable = 0;
+      int n = sscanf( args[2].sval, "%u", &enable );
+      if( 1 != n ) {
+        fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
+        return;
+      }
+      pthread->setHierarchical( enable != 0 );
+    }
+
+    // Set new period of full sweeps
+    if( strcmp( args[1].sval, "FullSweep" ) == 0 ) {
+      double newFullSweep = 0.;
+      int n = sscanf( args[2].sval, "%lf", &newFullSweep );
+      if( 1 != n || newFullSweep < 0. ) {
+        fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
+        return;
+      }
+      pthread->setFullSweep( newFullSweep );
+    }
+
+    // Enable/disable skipping of polls without new isegHAL cycle
+    if( strcmp( args[1].sval, "CycleGate" ) == 0 ) {
+      unsigned enable = 0;
+      int n = sscanf( args[2].sval, "%u", &enable );
+      if( 1 != n ) {
+        fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
+        return;
+      }
+      pthread->setCycleGate( enable != 0 );
+    }
+
+    // Set lane of the worker pool
+    if( strcmp( args[1].sval, "Lane" ) == 0 ) {
+      unsigned newLane = 0;
+      int n = sscanf( args[2].sval, "%u", &newLane );
+      if( 1 != n ) {
+        fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
+        return;
+      }
+      pthread->setLane( newLane );
+    }
+
+    // Set window for coalescing writes
+    if( strcmp( args[1].sval, "WriteWindow" ) == 0 ) {
+      double newWindow = 0.;
+      int n = sscanf( args[2].sval, "%lf", &newWindow );
+      if( 1 != n || newWindow < 0. ) {
+        fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
+        return;
+      }
+      pthread->writer.setWindow( newWindow );
+    }
+
+    // Set window, period and settling of the fast-follow after writes
+    if( strcmp( args[1].sval, "FollowWindow" ) == 0 ) {
+      double newWindow = 0.;
+      int n = sscanf( args[2].sval, "%lf", &newWindow );
+      if( 1 != n || newWindow < 0. ) {
+        fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
+        return;
+      }
+      pthread->setFollowWindow( newWindow );
+    }
+
+    if( strcmp( args[1].sval, "FollowPeriod" ) == 0 ) {
+      double newPeriod = 0.;
+      int n = sscanf( args[2].sval, "%lf", &newPeriod );
+      if( 1 != n || !( newPeriod > 0. ) ) {
+        fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
+        return;
+      }
+      pthread->setFollowPeriod( newPeriod );
+    }
+
+    if( strcmp( args[1].sval, "FollowSettle" ) == 0 ) {
+      unsigned newSettle = 0;
+      int n = sscanf( args[2].sval, "%u", &newSettle );
+      if( 1 != n ) {
+        fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
+        return;
+      }
+      pthread->setFollowSettle( newSettle );
+    }
+
+    // Set related items of the fast-follow
+    if( strncmp( args[1].sval, "Follow:", 7 ) == 0 ) {
+      pthread->setRelated( args[1].sval + 7, args[2].sval );
+    }
+
+    // Defer reading the initial values of the records until after iocInit
+    if( strcmp( args[1].sval, "DeferInit" ) == 0 ) {
+      unsigned enable = 0;
+      int n = sscanf( args[2].sval, "%u", &enable );
+      if( 1 != n ) {
+        fprintf( stderr, "\033[31;1mInvalid value for key '%s': %s\033[0m\n", args[1].sval, args[2].sval );
+        return;
+      }
+      pthread->setDeferInit( enable != 0 );
     }
 
   }
@@ -777,10 +3379,48 @@ extern "C" {
     if ( firstTime ) {
       iocshRegister( &setOptFuncDef, setOptCallFunc );
       iocshRegister( &isegConnectFuncDef, isegConnectCallFunc );
+      iocshRegister( &isegConnectAllFuncDef, isegConnectAllCallFunc );
+      iocshRegister( &snapshotFuncDef, snapshotCallFunc );
+      initHookRegister( devIsegHalInitHook );
+      iocshRegister( &parseBenchFuncDef, parseBenchCallFunc );
+      iocshRegister( &slotHammerFuncDef, slotHammerCallFunc );
+      iocshRegister( &setWorkersFuncDef, setWorkersCallFunc );
+      iocshRegister( &broadcastFuncDef, broadcastCallFunc );
       firstTime = false;
     }
   }
   
   epicsExportRegistrar( devIsegHalRegister );
+
+  //----------------------------------------------------------------------------
+  //! @brief       Register the functions sending frames to the hardware for tests
+  //!
+  //! Only registered if devIsegHalTest.dbd is loaded by the IOC.
+  //----------------------------------------------------------------------------
+  void devIsegHalTestRegister( void ) {
+    static bool firstTime = true;
+    if ( firstTime ) {
+      iocshRegister( &emergencyBenchFuncDef, emergencyBenchCallFunc );
+      firstTime = false;
+    }
+  }
+
+  epicsExportRegistrar( devIsegHalTestRegister );
+
+  //----------------------------------------------------------------------------
+  //! @brief       Driver report, called via "dbior( "drvIsegHal", LEVEL )"
+  //! @param [in]  level   Level of detail
+  //----------------------------------------------------------------------------
+  static long drvIsegHalReport( int level ) {
+    isegHalConnectionHandler::instance().report( level );
+    return OK;
+  }
+
+  static drvet drvIsegHal = {
+    2,
+    (DRVSUPFUN)drvIsegHalReport,
+    NULL
+  };
+  epicsExportAddress( drvet, drvIsegHal );
 }
 
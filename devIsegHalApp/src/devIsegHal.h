@@ -40,6 +40,7 @@
 #include <dbScan.h>
 #include <devSup.h>
 #include <epicsTime.h>
+#include <epicsTypes.h>
 #include <shareLib.h>
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
@@ -49,7 +50,30 @@
 #define DO_NOT_CONVERT        2
 #define ERROR                 -1
 
-typedef long (*DEVSUPINT)(dbCommon*, char* ); /**< internal device support function */
+/**
+ * @brief Data type of an isegHAL item
+ */
+typedef enum {
+  devIsegHalTypeString,   /**< STR and all other data types */
+  devIsegHalTypeDouble,   /**< R4 */
+  devIsegHalTypeUInt      /**< UI1, UI4 and BOOL */
+} devIsegHal_type_t;
+
+/**
+ * @brief Value of an isegHAL item
+ *
+ * The value cstring from isegHAL is parsed once according to the
+ * data type of the item. Records read the typed value directly.
+ */
+typedef struct {
+  devIsegHal_type_t type;                   /**< Data type of the item */
+  bool valid;                               /**< Cstring was parsed successfully */
+  epicsFloat64 dval;                        /**< Value of R4 items */
+  epicsUInt32 uval;                         /**< Value of UI1, UI4 and BOOL items */
+  char str[VALUE_SIZE];                     /**< Value cstring from isegHAL */
+} devIsegHal_value_t;
+
+typedef long (*DEVSUPINT)(dbCommon*, devIsegHal_value_t* ); /**< internal device support function */
 
 /**
  * @brief Device Support Entry Table
@@ -64,7 +88,7 @@ typedef struct {
   DEVSUPFUN ioint_info;   /**< get io interrupt info */
   DEVSUPFUN read_write;   /**< read/write value */
   DEVSUPFUN special_conv; /**< convertion for ai/ao records */
-	DEVSUPINT conv_val_str; /**< Convert value to cstring and vise versa*/
+	DEVSUPINT conv_val_str; /**< Convert value to devIsegHal_value_t and vise versa*/
 } devIsegHal_dset_t;
 
 /**
@@ -78,8 +102,22 @@ typedef struct {
   const char   access[ACCESS_SIZE];
   const char   type[DATA_TYPE_SIZE];
   const bool   registerCallback;
+  epicsUInt32  mask;                        /**< Bits of a register used by the record, 0 for the whole item */
 } devIsegHal_rec_t;
 
+/**
+ * @brief Array configuration
+ *
+ * Fields of aai, aao and waveform records needed to
+ * access the array of the record
+ */
+typedef struct {
+  void **pbptr;                             /**< Address of the field BPTR */
+  epicsEnum16 ftvl;                         /**< Field type of the array elements */
+  epicsUInt32 nelm;                         /**< Maximum number of elements */
+  epicsUInt32 *pnord;                       /**< Address of the field NORD */
+} devIsegHal_array_t;
+
 /**
  * @brief Private Device Data
  *
@@ -89,10 +127,29 @@ typedef struct {
   char object[FULLY_QUALIFIED_OBJECT_SIZE]; /**< Object name for isegHAL */
   char interface[20];                       /**< Interface name for isegHAL */
   char unit[UNIT_SIZE];                     /**< Engeneering unit of this item */
-  CALLBACK *pcallback;                      /**< Address of EPICS callback structure */
-  IOSCANPVT ioscanpvt;                      /**< EPICS Structure needed for I/O Intrupt handling*/
-  char value[VALUE_SIZE];                   /**< Value cstring from isegHAL */
+  dbCommon *prec;                           /**< Address of the record */
+  bool output;                              /**< Output record, updated by readback instead of I/O Intr */
+  int readback;                             /**< New readback value pending for an output record (atomic) */
+  bool inReadback;                          /**< Record is processed to update its readback value */
+  bool pending;                             /**< Readback is in the pending set of the dispatcher */
+  void *ppoller;                            /**< Address of polling thread of the interface */
+  void *pclass;                             /**< Address of poll class of this record */
+  void *pitem;                              /**< Address of shared item of this record */
+  long pollIndex;                           /**< Position within the subscribers of the item, -1 if not polled */
+  IOSCANPVT ioscanpvt;                      /**< I/O Intr scan list shared by the records of a module */
+  devIsegHal_value_t value;                 /**< Value from isegHAL */
   epicsTimeStamp time;                      /**< Timestamp of last change from isegHAL */
+  CALLBACK callback;                        /**< Completes the record after an asynchronous write */
+  CALLBACK readbackCallback;                /**< Processes an output record to update its readback value */
+  long writeStatus;                         /**< Result of the last asynchronous write */
+  int windowError;                          /**< Write within the write window failed, not reported yet (atomic) */
+  size_t writeErrors;                       /**< Number of failed writes of the record (atomic) */
+  void *parray;                             /**< Address of the elements of array records, NULL otherwise */
+  void *pparent;                            /**< Address of the private data of the array record of an element, NULL otherwise */
+  void *pemergency;                         /**< Prebuilt frames of emergency off records, NULL otherwise */
+  epicsUInt32 mask;                         /**< Bits of a register used by the record, 0 for the whole item */
+  unsigned short shift;                     /**< Position of the value within the register */
+  bool stale;                               /**< Value from the snapshot file, not yet confirmed by isegHAL */
 } devIsegHal_info_t;
 
 #ifdef __cplusplus
@@ -106,8 +163,14 @@ epicsShareExtern long devIsegHalRead( dbCommon *prec );
 epicsShareExtern long devIsegHalWrite( dbCommon *prec );
 epicsShareExtern long devIsegHalGlobalSwitchInit( dbCommon *prec, const devIsegHal_rec_t *pconf );
 epicsShareExtern long devIsegHalGlobalSwitchWrite( dbCommon *prec );
-
-epicsShareExtern void devIsegHalCallback( CALLBACK *pcallback );
+epicsShareExtern long devIsegHalBroadcastWrite( dbCommon *prec, const char *frames );
+epicsShareExtern long devIsegHalEmergencyInit( dbCommon *prec, const char *off, const char *on );
+epicsShareExtern long devIsegHalEmergencyWrite( dbCommon *prec, bool on );
+epicsShareExtern long devIsegHalStatInit( dbCommon *prec, const devIsegHal_rec_t *pconf );
+epicsShareExtern long devIsegHalStatRead( dbCommon *prec, epicsFloat64 *pvalue );
+epicsShareExtern long devIsegHalArrayInitRecord( dbCommon *prec, const devIsegHal_rec_t *pconf, const devIsegHal_array_t *parr );
+epicsShareExtern long devIsegHalArrayRead( dbCommon *prec );
+epicsShareExtern long devIsegHalArrayWrite( dbCommon *prec );
 
 #ifdef __cplusplus
 } //extern "C"
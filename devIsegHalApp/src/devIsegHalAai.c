@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+ *                    - Helmholtz-Institut Mainz
+ *
+ * This file is part of devIsegHal
+ *
+ * devIsegHal is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * devIseghal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * version 2.1.0; October 16, 2026
+ *
+*******************************************************************************/
+
+/**
+ * @file devIsegHalAai.c
+ * @author F.Feldbauer
+ * @date 16 October 2026
+ * @brief Device Support implementation for aai records
+ */
+
+/*_____ I N C L U D E S ______________________________________________________*/
+
+/* ANSI C includes  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* EPICS includes */
+#include <aaiRecord.h>
+#include <alarm.h>
+#include <dbAccess.h>
+#include <errlog.h>
+#include <epicsExport.h>
+#include <epicsTypes.h>
+#include <recGbl.h>
+
+/* local includes */
+#include "devIsegHal.h"
+
+/*_____ D E F I N I T I O N S ________________________________________________*/
+static long devIsegHalInitRecord_aai( aaiRecord *prec );
+
+/*_____ G L O B A L S ________________________________________________________*/
+devIsegHal_dset_t devIsegHalAai = {
+  5,
+  NULL,
+  devIsegHalInit,
+  devIsegHalInitRecord_aai,
+  devIsegHalGetIoIntInfo,
+  devIsegHalArrayRead,
+  NULL,
+  NULL
+};
+epicsExportAddress( dset, devIsegHalAai );
+
+/*_____ L O C A L S __________________________________________________________*/
+
+/*_____ F U N C T I O N S ____________________________________________________*/
+
+/**-----------------------------------------------------------------------------
+ * @brief   Initialization of aai records
+ * @param   [in]  prec   Address of the record calling this function
+ * @return  In case of error return -1, otherwise return 0
+ *
+ * The INP field names an item of all channels of a module,
+ * e.g. "@0.0.*.VoltageMeasure can0".
+ *----------------------------------------------------------------------------*/
+static long devIsegHalInitRecord_aai( aaiRecord *prec ){
+  prec->pact = (epicsUInt8)true; /* disable record */
+
+  devIsegHal_rec_t conf = { &prec->inp, "R", "", false };
+  devIsegHal_array_t array = { &prec->bptr, prec->ftvl, prec->nelm, &prec->nord };
+  long status = devIsegHalArrayInitRecord( (dbCommon*)prec, &conf, &array );
+  if( status != 0 ) return ERROR;
+
+  devIsegHal_info_t* pinfo = (devIsegHal_info_t*)prec->dpvt;
+  if( strlen( prec->egu ) == 0 ) strcpy( prec->egu, pinfo->unit );
+
+  prec->pact = (epicsUInt8)false; /* enable record */
+
+  return OK;
+}
+
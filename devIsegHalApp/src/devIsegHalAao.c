@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2015 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+ * Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
  *                    - Helmholtz-Institut Mainz
  *
  * This file is part of devIsegHal
@@ -18,57 +18,77 @@
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  *
- * version 2.0.0; May 25, 2015
+ * version 2.1.0; October 16, 2026
  *
 *******************************************************************************/
 
 /**
- * @file devIsegHalAsync.c
+ * @file devIsegHalAao.c
  * @author F.Feldbauer
- * @date 25 May 2015
- * @brief Implementation of async callback function 
+ * @date 16 October 2026
+ * @brief Device Support implementation for aao records
  */
 
 /*_____ I N C L U D E S ______________________________________________________*/
 
 /* ANSI C includes  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* EPICS includes */
-#include <dbLock.h>
-#include <recSup.h>
+#include <aaoRecord.h>
+#include <alarm.h>
+#include <dbAccess.h>
+#include <errlog.h>
+#include <epicsExport.h>
+#include <epicsTypes.h>
+#include <recGbl.h>
 
 /* local includes */
 #include "devIsegHal.h"
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
+static long devIsegHalInitRecord_aao( aaoRecord *prec );
 
 /*_____ G L O B A L S ________________________________________________________*/
+devIsegHal_dset_t devIsegHalAao = {
+  5,
+  NULL,
+  devIsegHalInit,
+  devIsegHalInitRecord_aao,
+  NULL,
+  devIsegHalArrayWrite,
+  NULL,
+  NULL
+};
+epicsExportAddress( dset, devIsegHalAao );
 
 /*_____ L O C A L S __________________________________________________________*/
 
 /*_____ F U N C T I O N S ____________________________________________________*/
 
 /**-----------------------------------------------------------------------------
- * @brief   Callback for asynchronous handling of set parameters
- * @param   [in]  pcallback   Address of EPICS CALLBACK structure
+ * @brief   Initialization of aao records
+ * @param   [in]  prec   Address of the record calling this function
+ * @return  In case of error return -1, otherwise return 0
  *
- * This callback processes the the record defined in callback user.
- * This function cannot be implemented in file devIsegHal.cpp
- * because function call "(*prset->process)( prec )" is invalid in C++:
- * rset::process is of type "long (*RECSUPFUN) ()"
+ * The OUT field names an item of all channels of a module,
+ * e.g. "@0.0.*.VoltageSet can0".
  *----------------------------------------------------------------------------*/
-void devIsegHalCallback( CALLBACK *pcallback ) {
-  dbCommon *prec;
-  rset     *prset;
+static long devIsegHalInitRecord_aao( aaoRecord *prec ){
+  prec->pact = (epicsUInt8)true; /* disable record */
 
-  callbackGetUser( prec, pcallback );
+  devIsegHal_rec_t conf = { &prec->out, "WR", "", true };
+  devIsegHal_array_t array = { &prec->bptr, prec->ftvl, prec->nelm, &prec->nord };
+  long status = devIsegHalArrayInitRecord( (dbCommon*)prec, &conf, &array );
+  if( status != 0 ) return ERROR;
 
-  prec->pact = (epicsUInt8)true;
-  prset = (rset*)(prec->rset);
+  devIsegHal_info_t* pinfo = (devIsegHal_info_t*)prec->dpvt;
+  if( strlen( prec->egu ) == 0 ) strcpy( prec->egu, pinfo->unit );
 
-  dbScanLock( prec );
-  (*prset->process)( prec );
-//  dbProcess( prec );
-  dbScanUnlock( prec );
+  prec->pact = (epicsUInt8)false; /* enable record */
+
+  return OK;
 }
 
@@ -54,7 +54,7 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalInitRecord_ai( aiRecord *prec );
-static long devIsegHalRead_ai( dbCommon *prec, char* value ); 
+static long devIsegHalRead_ai( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalAi = {
@@ -95,19 +95,18 @@ static long devIsegHalInitRecord_ai( aiRecord *prec ){
 }
 
 /**-----------------------------------------------------------------------------
- * @brief   Parse value from cstring for ai Records
+ * @brief   Read value for ai Records
  * @param   [in]  prec   Address of the record calling this function
- * @param   [in]  value  Address of cstring containing value
+ * @param   [in]  pval   Address of parsed value
  * @return  -1 in case of error
  *           2 (no conversion)
  *----------------------------------------------------------------------------*/
-static long devIsegHalRead_ai( dbCommon *prec, char* value ) {
+static long devIsegHalRead_ai( dbCommon *prec, devIsegHal_value_t* pval ) {
   aiRecord *pai = (aiRecord*)prec;
-  epicsFloat64 buffer = 0.;
-  if( sscanf( value, "%lf", &buffer ) != 1 ) {
+  if( !pval->valid ) {
     return ERROR;
   }
-  pai->val = buffer;
+  pai->val = pval->dval;
   return DO_NOT_CONVERT;
 }
 
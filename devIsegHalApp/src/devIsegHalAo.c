@@ -55,7 +55,7 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalInitRecord_ao( aoRecord *prec );
-static long devIsegHalWrite_ao( dbCommon *prec, char* value ); 
+static long devIsegHalWrite_ao( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalAo = {
@@ -98,27 +98,26 @@ static long devIsegHalInitRecord_ao( aoRecord *prec ){
 /**-----------------------------------------------------------------------------
  * @brief   Convert value to cstring for ao Records
  * @param   [in]  prec    Address of the record calling this function
- * @param   [out] value   Address of cstring containing value
+ * @param   [out] pval    Address of value
  * @return  -1 in case of error
  *          0
  *
  * Upon normal process of the record, the current contents of the VAL field
  * is converted into a cstring. If PACT is set to true (process via callback)
- * the cstring is instead parsed and its value written to VAL field.
+ * the parsed value is instead written to VAL field.
  *----------------------------------------------------------------------------*/
-static long devIsegHalWrite_ao( dbCommon *prec, char* value ) {
+static long devIsegHalWrite_ao( dbCommon *prec, devIsegHal_value_t* pval ) {
   aoRecord* pao = (aoRecord *)prec;
 
   if( pao->pact ) {
-    epicsFloat64 buffer = 0.;
-    if( sscanf( value, "%lf", &buffer ) != 1 ) {
+    if( !pval->valid ) {
       return ERROR;
     }
-    pao->val = buffer;
+    pao->val = pval->dval;
     return DO_NOT_CONVERT;
   }
 
-  if( sprintf( value, "%lf", pao->val ) < 0 ) {
+  if( sprintf( pval->str, "%lf", pao->val ) < 0 ) {
     return ERROR;
   }
   return OK;
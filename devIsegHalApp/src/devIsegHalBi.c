@@ -54,7 +54,7 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalInitRecord_bi( biRecord *prec );
-static long devIsegHalRead_bi( dbCommon *prec, char* value ); 
+static long devIsegHalRead_bi( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalBi = {
@@ -91,18 +91,17 @@ static long devIsegHalInitRecord_bi( biRecord *prec ){
 }
 
 /**-----------------------------------------------------------------------------
- * @brief   Parse value from cstring for bi records
+ * @brief   Read value for bi records
  * @param   [in]  prec   Address of the record calling this function
- * @param   [in]  value  Address of cstring containing value
+ * @param   [in]  pval   Address of parsed value
  * @return  -1 in case of error, otherwise 0
  *----------------------------------------------------------------------------*/
-static long devIsegHalRead_bi( dbCommon *prec, char* value ) {
+static long devIsegHalRead_bi( dbCommon *prec, devIsegHal_value_t* pval ) {
   biRecord *pbi = (biRecord*)prec;
-  epicsUInt32 buffer = 0;
-  if( sscanf( value, "%u", &buffer ) != 1 ) {
+  if( !pval->valid ) {
     return ERROR;
   }
-  pbi->rval  = ( buffer ? 1 : 0 );
+  pbi->rval  = ( pval->uval ? 1 : 0 );
   return OK;
 }
 
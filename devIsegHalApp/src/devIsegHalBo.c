@@ -54,7 +54,7 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalInitRecord_bo( boRecord *prec );
-static long devIsegHalWrite_bo( dbCommon *prec, char* value ); 
+static long devIsegHalWrite_bo( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalBo = {
@@ -93,28 +93,27 @@ static long devIsegHalInitRecord_bo( boRecord *prec ){
 /**-----------------------------------------------------------------------------
  * @brief   Convert value to cstring for bo records
  * @param   [in]  prec   Address of the record calling this function
- * @param   [in]  value  Address of cstring containing value
+ * @param   [in]  pval   Address of value
  * @return  -1 in case of error, otherwise 0
  *
  * Upon normal process of the record, the current contents of the VAL field
  * is converted into a cstring. If PACT is set to true (process via callback)
- * the cstring is instead parsed and its value written to VAL field.
+ * the parsed value is instead written to VAL field.
  *----------------------------------------------------------------------------*/
-static long devIsegHalWrite_bo( dbCommon *prec, char* value ) {
+static long devIsegHalWrite_bo( dbCommon *prec, devIsegHal_value_t* pval ) {
   boRecord *pbo = (boRecord *)prec;
 
   if( pbo->pact ) {
-    epicsUInt32 buffer = 0;
-    if( sscanf( value, "%u", &buffer ) != 1 ) {
+    if( !pval->valid ) {
       return ERROR;
     }
-    pbo->val   = ( buffer ? 1 : 0 );
-    pbo->rval  = ( buffer ? 1 : 0 );
+    pbo->val   = ( pval->uval ? 1 : 0 );
+    pbo->rval  = ( pval->uval ? 1 : 0 );
     return OK;
   }
 
-  value[0] = ( pbo->rval ? '1' : '0' );
-  value[1] = 0; /* just to be sure */
+  pval->str[0] = ( pbo->rval ? '1' : '0' );
+  pval->str[1] = 0; /* just to be sure */
   return OK;
 }
 
@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+ *                    - Helmholtz-Institut Mainz
+ *
+ * This file is part of devIsegHal
+ *
+ * devIsegHal is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * devIseghal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * version 2.1.0; October 16, 2026
+ *
+*******************************************************************************/
+
+/**
+ * @file devIsegHalBroadcastLso.c
+ * @author F.Feldbauer
+ * @date 16 October 2026
+ * @brief Device Support for lso records sending a batch of broadcast frames
+ */
+
+/*_____ I N C L U D E S ______________________________________________________*/
+
+/* ANSI C includes  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* EPICS includes */
+#include <lsoRecord.h>
+#include <alarm.h>
+#include <dbAccess.h>
+#include <errlog.h>
+#include <epicsExport.h>
+#include <epicsTypes.h>
+#include <recGbl.h>
+
+/* local includes */
+#include "devIsegHal.h"
+
+/*_____ D E F I N I T I O N S ________________________________________________*/
+static long devIsegHalBroadcastInitRecord_lso( lsoRecord *prec );
+static long devIsegHalBroadcastWrite_lso( lsoRecord *prec );
+
+/*_____ G L O B A L S ________________________________________________________*/
+devIsegHal_dset_t devIsegHalBroadcastLso = {
+  5,
+  NULL,
+  devIsegHalInit,
+  devIsegHalBroadcastInitRecord_lso,
+  NULL,
+  devIsegHalBroadcastWrite_lso,
+  NULL,
+  NULL
+};
+epicsExportAddress( dset, devIsegHalBroadcastLso );
+
+/*_____ L O C A L S __________________________________________________________*/
+
+/*_____ F U N C T I O N S ____________________________________________________*/
+
+/**-----------------------------------------------------------------------------
+ * @brief   Initialization of lso records
+ * @param   [in]  prec   Address of the record calling this function
+ * @return  In case of error return -1, otherwise return 0
+ *----------------------------------------------------------------------------*/
+static long devIsegHalBroadcastInitRecord_lso( lsoRecord *prec ){
+  devIsegHal_rec_t conf = { &prec->out, "", "", false };
+  long status = devIsegHalGlobalSwitchInit( (dbCommon*)prec, &conf );
+  if( status != 0 ) return ERROR;
+
+  devIsegHal_info_t* pinfo = (devIsegHal_info_t*)prec->dpvt;
+  if( 'B' != pinfo->object[0] ) {
+    fprintf( stderr, "\033[31;1m%s: lso records only support \"@Batch <Interface>\"\033[0m\n", prec->name );
+    return ERROR;
+  }
+  return OK;
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Send the frames in VAL as one batch of broadcasts
+ * @param   [in]  prec   Address of the record calling this function
+ * @return  -1 in case of error, otherwise 0
+ *----------------------------------------------------------------------------*/
+static long devIsegHalBroadcastWrite_lso( lsoRecord *prec ) {
+  return devIsegHalBroadcastWrite( (dbCommon*)prec, prec->val );
+}
@@ -29,40 +29,552 @@
 //_____ I N C L U D E S ________________________________________________________
 
 // ANSI C/C++ includes  */
+#include <deque>
+#include <functional>
 #include <list>
+#include <map>
+#include <queue>
 #include <string>
 #include <vector>
 
 // EPICS includes
+#include <callback.h>
 #include <dbAccess.h>
+#include <epicsAtomic.h>
+#include <epicsEvent.h>
+#include <epicsMutex.h>
 #include <epicsThread.h>
+#include <epicsTime.h>
 
 // local includes
 #include "devIsegHal.h"
 
 //_____ D E F I N I T I O N S __________________________________________________
 
+class isegHalThread;
+struct isegHalScanGroup;
+struct isegHalSnapshotProperty;
+struct isegHalSnapshotValue;
+
+//! Time in seconds until deferred updates are dispatched again
+static const double dispatchRetry = 0.1;
+
+void processReadback( devIsegHal_info_t* pinfo );
+
 //! @brief   Handler for iseg interfaces
 //!
 //! This class handles the connection of the used
 //! interfaces to the isegHal server.
+//! Each interface owns its own polling thread, so a slow
+//! or busy line does not delay the updates of the others.
 //! This class uses the singleton design pattern
 class isegHalConnectionHandler {
  public:
 
    static isegHalConnectionHandler& instance();
 
-   bool connect( std::string const& name, std::string const& interface );
+   bool connect( std::string const& name, std::string const& interface, double timeout = 0. );
+   bool connectAll( std::vector< std::pair< std::string, std::string > > const& interfaces, double timeout );
    bool connected( std::string const& name );
    void disconnect( std::string const& interface );
 
+   isegHalThread* poller( std::string const& name );
+   void startPollers();
+   void fetchInitial();
+   void snapshot( std::vector< isegHalSnapshotValue >& values ) const;
+   void report( int level );
+
  private:
-  isegHalConnectionHandler() {};
+  isegHalConnectionHandler() : _pollersStarted( false ) {};
   ~isegHalConnectionHandler();
   isegHalConnectionHandler( isegHalConnectionHandler const& rother ); //!< copy constructor, not implemented
   isegHalConnectionHandler& operator=( isegHalConnectionHandler const& rother ); //!< Copy assignment operator not implemented
 
+  double waitReady( std::string const& name, double timeout );
+  bool modulesListed( std::string const& name );
+
   std::vector< std::string > _interfaces;
+  std::vector< std::string > _connecting;                 //!< names passed to iseg_connect, not yet connected
+  std::map< std::string, double > _readyTime;             //!< seconds until isegHAL was ready, negative on timeout
+  std::map< std::string, isegHalThread* > _pollers;
+  bool _pollersStarted;
+  mutable epicsMutex _lock;                               //!< interfaces may be connected concurrently
+};
+
+//! @brief   Thread connecting one interface
+//!
+//! Used by isegHalConnectionHandler::connectAll to wait for the
+//! readiness of several interfaces concurrently.
+class isegHalConnector: public epicsThreadRunable {
+ public:
+  isegHalConnector( std::string const& name, std::string const& interface, double timeout );
+  virtual ~isegHalConnector() {}
+  virtual void run();
+  epicsThread thread;
+  epicsEvent done;                        //!< signaled once the connect returned
+
+  std::string name;                       //!< deviseg internal name of the interface handle
+  std::string interface;                  //!< name of the hardware interface
+  double timeout;                         //!< maximum time to wait until isegHAL is ready
+  bool connected;                         //!< result of the connect
+  double duration;                        //!< time needed for the connect in seconds
+
+ private:
+  isegHalConnector( isegHalConnector const& rother ); //!< copy constructor, not implemented
+  isegHalConnector& operator=( isegHalConnector const& rother ); //!< Copy assignment operator not implemented
+};
+
+//! @brief   Worker thread processing records
+//!
+//! Each worker owns one lane, a bounded queue of jobs. A job either
+//! scans the I/O Intr records of a scan group or processes an output
+//! record to update its readback value.
+class isegHalWorker: public epicsThreadRunable {
+ public:
+  isegHalWorker( unsigned lane, unsigned priority, size_t depth );
+  virtual ~isegHalWorker() {}
+  virtual void run();
+  epicsThread thread;
+
+  bool request( isegHalScanGroup* pgroup, unsigned prioMask );
+  bool request( devIsegHal_info_t* pinfo );
+  void report() const;
+
+ private:
+  isegHalWorker( isegHalWorker const& rother ); //!< copy constructor, not implemented
+  isegHalWorker& operator=( isegHalWorker const& rother ); //!< Copy assignment operator not implemented
+
+  //! Job of the worker, either a scan group with the priorities to scan or a record
+  struct job_t {
+    isegHalScanGroup* pgroup;
+    unsigned prioMask;
+    devIsegHal_info_t* pinfo;
+  };
+
+  bool push( job_t const& job );
+
+  unsigned _lane;
+  size_t _depth;
+  mutable epicsMutex _lock;
+  epicsEvent _event;
+  std::deque< job_t > _queue;
+
+  // statistics
+  unsigned long _jobs;
+  unsigned long _overflows;
+  size_t _maxQueued;
+};
+
+//! @brief   Pool of worker threads processing records
+//!
+//! The record updates of all interfaces are processed by isegHAL-owned
+//! worker threads instead of the shared EPICS callback
+//! threads. Each interface is assigned to one lane, so its updates are
+//! processed in order, while different interfaces run on different cores.
+//! With 0 threads the standard EPICS threads are used.
+//! This class uses the singleton design pattern
+class isegHalWorkerPool {
+ public:
+  static isegHalWorkerPool& instance();
+
+  bool configure( unsigned threads, unsigned priority, unsigned depth );
+  void start();
+  isegHalWorker* worker( unsigned lane );
+  inline unsigned lanes() const { return _threads; }
+  void report( int level ) const;
+
+ private:
+  isegHalWorkerPool();
+  ~isegHalWorkerPool() {}
+  isegHalWorkerPool( isegHalWorkerPool const& rother ); //!< copy constructor, not implemented
+  isegHalWorkerPool& operator=( isegHalWorkerPool const& rother ); //!< Copy assignment operator not implemented
+
+  unsigned _threads;
+  unsigned _priority;
+  unsigned _depth;
+  std::vector< isegHalWorker* > _workers;
+};
+
+//! @brief   Cache of item properties
+//!
+//! Channel and module items of the same name have the same properties
+//! on all modules of the same type. Their properties are read from isegHAL
+//! once per interface, module type (item "Article" of the module) and
+//! item name. Channel items are only taken from the cache for channels
+//! below the "ChannelNumber" of the module. Other items are always read
+//! from isegHAL.
+//! This class uses the singleton design pattern
+class isegHalPropertyCache {
+ public:
+  static isegHalPropertyCache& instance();
+
+  IsegItemProperty get( std::string const& interface, std::string const& object );
+  void snapshot( std::vector< isegHalSnapshotProperty >& properties ) const;
+  void report( int level ) const;
+
+ private:
+  isegHalPropertyCache();
+  ~isegHalPropertyCache() {}
+  isegHalPropertyCache( isegHalPropertyCache const& rother ); //!< copy constructor, not implemented
+  isegHalPropertyCache& operator=( isegHalPropertyCache const& rother ); //!< Copy assignment operator not implemented
+
+  std::string moduleType( std::string const& interface, std::string const& module );
+  epicsUInt32 moduleChannels( std::string const& interface, std::string const& module );
+
+  mutable epicsMutex _lock;
+  std::map< std::string, IsegItemProperty > _properties; //!< properties by interface, module type and item name
+  std::map< std::string, std::string > _modules;         //!< module types by interface and module
+  std::map< std::string, epicsUInt32 > _channels;        //!< channel numbers by interface and module
+  std::map< std::pair< std::string, std::string >, IsegItemProperty > _objects; //!< properties by interface and object
+  unsigned long _snapshotHits;
+  unsigned long _hits;
+  unsigned long _misses;
+  unsigned long _uncached;
+  double _missTime;                       //!< time of reading cached properties from isegHAL
+  double _lookupTime;                     //!< time of reading the module types and channel numbers from isegHAL
+};
+
+//! @brief   Header of the snapshot file
+struct isegHalSnapshotHeader {
+  char magic[8];                          //!< "ISEGSNAP"
+  epicsUInt32 version;                    //!< version of the file format
+  epicsUInt32 propertySize;               //!< size of a property entry
+  epicsUInt32 valueSize;                  //!< size of a value entry
+  epicsUInt32 properties;                 //!< number of property entries
+  epicsUInt32 values;                     //!< number of value entries
+  epicsTimeStamp time;                    //!< time the snapshot was written
+};
+
+//! @brief   Item property within the snapshot file, sorted by interface and object
+struct isegHalSnapshotProperty {
+  char interface[20];                     //!< Interface name for isegHAL
+  IsegItemProperty property;              //!< Property of the item
+};
+
+//! @brief   Item value within the snapshot file, sorted by interface and object
+struct isegHalSnapshotValue {
+  char interface[20];                     //!< Interface name for isegHAL
+  char object[FULLY_QUALIFIED_OBJECT_SIZE]; //!< Object name for isegHAL
+  char value[VALUE_SIZE];                 //!< Value cstring from isegHAL
+  epicsTimeStamp time;                    //!< Timestamp of last change from isegHAL
+};
+
+//! @brief   Snapshot file of item properties and last values
+//!
+//! The file is memory-mapped on load. Records are initialized from it
+//! without reading isegHAL, their values are flagged stale until the
+//! polling thread has read them from isegHAL.
+//! After iocInit the snapshot is written periodically and at exit.
+//! This class uses the singleton design pattern
+class isegHalSnapshot: public epicsThreadRunable {
+ public:
+  static isegHalSnapshot& instance();
+  virtual void run();
+
+  bool configure( std::string const& file, double period );
+  bool property( const char* interface, const char* object, IsegItemProperty& property );
+  bool value( const char* interface, const char* object, char* value, epicsTimeStamp& time );
+  void release();
+  bool save();
+  void report( int level ) const;
+
+ private:
+  isegHalSnapshot();
+  ~isegHalSnapshot() {}
+  isegHalSnapshot( isegHalSnapshot const& rother ); //!< copy constructor, not implemented
+  isegHalSnapshot& operator=( isegHalSnapshot const& rother ); //!< Copy assignment operator not implemented
+
+  bool load();
+  void unmap();
+
+  std::string _file;
+  double _period;
+  bool _armed;                            //!< records are initialized, the snapshot may be written
+  epicsThread* _pthread;
+  epicsEvent _event;
+  mutable epicsMutex _lock;
+  void* _pmap;                            //!< mapping of the loaded file, NULL if none
+  size_t _size;                           //!< size of the mapping
+  const isegHalSnapshotHeader* _pheader;
+  const isegHalSnapshotProperty* _pproperties;
+  const isegHalSnapshotValue* _pvalues;
+
+  // statistics
+  epicsTimeStamp _loaded;                 //!< time the loaded snapshot was written
+  unsigned long _loadedProperties;
+  unsigned long _loadedValues;
+  unsigned long _propertyHits;
+  unsigned long _valueHits;
+  unsigned long _saves;
+  unsigned long _errors;
+  double _saveTime;
+};
+
+//! @brief   Histogram of durations
+//!
+//! Durations are sorted into decade bins from 10 us up to 10 s.
+//! Additionally the last, maximum and mean value are recorded.
+class isegHalHistogram {
+ public:
+  isegHalHistogram() { reset(); }
+
+  void reset();
+  void add( double val );
+  void report( const char* title ) const;
+
+  inline unsigned long count() const { return _count; }
+  inline double last() const { return _last; }
+  inline double max() const { return _max; }
+  inline double mean() const { return _count ? _sum / _count : 0.; }
+
+ private:
+  enum { NBINS = 8 };
+  unsigned long _bins[NBINS];
+  unsigned long _count;
+  double _sum;
+  double _last;
+  double _max;
+};
+
+//! @brief   Registry of entries polled by the polling thread
+//!
+//! Registering and cancelling an entry is O(1), since each entry stores
+//! its position within the registry in its member pollIndex.
+//! The polling thread iterates over a private snapshot of the registry,
+//! which is only refreshed if the registry has been changed. Thus the
+//! polling thread never iterates over a list which is modified
+//! concurrently, and it does not block if the registry is locked.
+template< class T >
+class isegHalRegistry {
+ public:
+  isegHalRegistry() : _generation( 0 ), _snapshotGeneration( 0 ) {}
+
+  bool add( T* pentry );
+  bool remove( T* pentry );
+  size_t size() const;
+  std::vector< T* > entries() const;
+
+  std::vector< T* > const& snapshot();
+
+ private:
+  isegHalRegistry( isegHalRegistry const& rother ); //!< copy constructor, not implemented
+  isegHalRegistry& operator=( isegHalRegistry const& rother ); //!< Copy assignment operator not implemented
+
+  mutable epicsMutex _lock;
+  std::vector< T* > _entries;
+  std::vector< T* > _snapshot;
+  size_t _generation;                     //!< incremented with each change of the registry (atomic)
+  size_t _snapshotGeneration;
+};
+
+//! @brief   Thread writing values to isegHAL
+//!
+//! Puts to output records are not written within record processing.
+//! The value is queued to the writer thread of the interface and the
+//! record is left active (PACT=1). After iseg_setItem returned, the record
+//! is completed by a callback, so a slow isegHAL does not block the
+//! thread processing the put.
+//! With a write window, puts are completed immediately instead and held
+//! back for the window. A newer put to the same object replaces the
+//! pending value, so only the last value is written to isegHAL.
+class isegHalWriter: public epicsThreadRunable {
+ public:
+  isegHalWriter( std::string const& interface, size_t depth );
+  virtual ~isegHalWriter() {}
+  virtual void run();
+  epicsThread thread;
+
+  bool request( devIsegHal_info_t* pinfo, const char* value );
+  bool request( devIsegHal_info_t* pinfo, std::vector< devIsegHal_info_t* > const& elements,
+                std::vector< devIsegHal_value_t > const& values );
+  bool post( devIsegHal_info_t* pinfo, const char* value );
+  inline void setWindow( double val ) { _window = val; }
+  inline double window() const { return _window; }
+  void report( int level ) const;
+  bool statistic( std::string const& name, double& value ) const;
+
+ private:
+  isegHalWriter( isegHalWriter const& rother ); //!< copy constructor, not implemented
+  isegHalWriter& operator=( isegHalWriter const& rother ); //!< Copy assignment operator not implemented
+
+  //! Queued write of a record
+  struct job_t {
+    devIsegHal_info_t* pinfo;
+    char value[VALUE_SIZE];
+    epicsUInt64 queued;                   //!< time of the put on the monotonic clock
+    epicsUInt64 due;                      //!< earliest time of the write on the monotonic clock
+    devIsegHal_info_t* pcomplete;         //!< record waiting for the write, NULL if none
+    bool last;                            //!< last write of the record, complete it afterwards
+  };
+
+  bool push( job_t& job );
+  bool readRegister( const devIsegHal_info_t* pinfo, epicsUInt32& value );
+  bool complete();
+
+  //! Last written value of a register and its expiry on the monotonic clock
+  typedef std::pair< epicsUInt32, epicsUInt64 > register_t;
+
+  size_t _depth;
+  double _window;
+  mutable epicsMutex _lock;
+  epicsEvent _event;
+  std::deque< job_t > _queue;
+  std::map< std::string, register_t > _registers;  //!< only used by the writer thread
+  std::vector< devIsegHal_info_t* > _completions;  //!< records to complete, only used by the writer thread
+
+  // statistics
+  unsigned long _writes;
+  unsigned long _errors;
+  unsigned long _overflows;
+  unsigned long _elided;
+  unsigned long _registerWrites;
+  unsigned long _deferredCompletions;
+  size_t _maxQueued;
+  double _sumQueued;
+  isegHalHistogram _latency;
+};
+
+struct isegHalPollClass;
+
+//! @brief   Elements of an aai, aao or waveform record
+//!
+//! Each channel of the module is an element with its own private data,
+//! subscribed to the item of the channel like a scalar record.
+//! The array record itself is processed via the scan group of the module.
+struct isegHalArray {
+  devIsegHal_array_t array;                         //!< Array fields of the record
+  std::vector< devIsegHal_info_t* > elements;       //!< private data of the elements, one per channel
+  isegHalScanGroup* pgroup;                         //!< I/O Intr scan group of the module
+};
+
+//! @brief   Prebuilt frames of an emergency off record
+//!
+//! The frames are built at initialization, so an emergency off is sent
+//! without any conversion.
+struct isegHalEmergency {
+  std::string frames[2];                            //!< frames to clear (0) and set (1) the emergency off
+};
+
+//! @brief   Value and timestamp of an item, handed over lock-free
+//!
+//! The slot is only written by the polling thread and read by the threads
+//! processing the records. It is protected by a sequence counter (seqlock):
+//! the counter is odd while the slot is written, and a reader retries if
+//! the counter changed while it copied the slot. Thus readers always get a
+//! consistent pair of value and timestamp without taking a lock.
+struct isegHalSlot {
+  int seq;                                //!< sequence counter, odd while the slot is written
+  devIsegHal_value_t value;               //!< Value from isegHAL
+  epicsTimeStamp time;                    //!< Timestamp of last change from isegHAL
+
+  void store( devIsegHal_value_t const& newValue, epicsTimeStamp const& newTime );
+  void load( devIsegHal_value_t* pvalue, epicsTimeStamp* ptime ) const;
+
+  static bool hammer( double seconds, unsigned readers );
+};
+
+//! @brief   Reader thread of the slot stress test
+//!
+//! Loads the slot until stopped and checks that value and timestamp
+//! of each copy belong to the same store.
+class isegHalSlotReader: public epicsThreadRunable {
+ public:
+  isegHalSlotReader( isegHalSlot const& slot, unsigned index );
+  virtual ~isegHalSlotReader() {}
+  virtual void run();
+  epicsThread thread;
+  epicsEvent done;                        //!< signaled once the reader stopped
+
+  int stop;                               //!< set to stop the reader (atomic)
+  unsigned long loads;                    //!< number of loads
+  unsigned long torn;                     //!< number of inconsistent copies
+  unsigned long backwards;                //!< number of copies older than the previous one
+
+ private:
+  isegHalSlotReader( isegHalSlotReader const& rother ); //!< copy constructor, not implemented
+  isegHalSlotReader& operator=( isegHalSlotReader const& rother ); //!< Copy assignment operator not implemented
+
+  isegHalSlot const& _slot;
+};
+
+//! @brief   Group of records sharing one I/O Intr scan list
+//!
+//! The input records of one module, or of the interface for system and
+//! line items, are processed together by a single scanIoRequest.
+//! Only one scan request per group is in flight, changes arriving
+//! meanwhile are coalesced into one further request.
+struct isegHalScanGroup {
+  std::string name;                       //!< module ("line.module") or empty for the interface
+  IOSCANPVT ioscanpvt;                    //!< I/O Intr scan list of the group
+  isegHalThread* pthread;                 //!< polling thread owning this group
+  unsigned records[NUM_CALLBACK_PRIORITIES]; //!< number of I/O Intr records per priority
+  int inFlight;                           //!< number of queued scans not yet completed (atomic)
+  int pending;                            //!< group is in the pending set of the dispatcher (atomic)
+  bool deferred;                          //!< last dispatch of the group was deferred
+};
+
+//! @brief   isegHAL item shared by all records using it
+//!
+//! Each distinct object of an interface is polled only once per cycle,
+//! a new value is then handed to all subscribed records.
+//! The item is polled with the fastest poll class requested by its records.
+struct isegHalItem {
+  char object[FULLY_QUALIFIED_OBJECT_SIZE];         //!< Object name for isegHAL
+  char interface[20];                               //!< Interface name for isegHAL
+  isegHalSlot slot;                                 //!< Value and timestamp of last change from isegHAL
+  bool stale;                                       //!< Value from the snapshot file or not yet read, not yet confirmed by isegHAL
+  std::string module;                               //!< Module ("line.module") of channel items, empty otherwise
+  isegHalScanGroup* pgroup;                         //!< I/O Intr scan group of this item
+  long pollIndex;                                   //!< Position within the registry of its poll class
+  isegHalPollClass* pclass;                         //!< poll class of this item, NULL if not polled
+  isegHalRegistry< devIsegHal_info_t > subscribers; //!< records using this item
+};
+
+//! @brief   Event and status register of a module
+//!
+//! Used by the hierarchical polling to decide whether the channel
+//! items of a module have to be read within a cycle of a poll class.
+struct isegHalModuleGate {
+  std::string eventStatus;                //!< Object name of the module's EventStatus
+  std::string status;                     //!< Object name of the module's Status
+  epicsUInt32 lastEventStatus;            //!< EventStatus at the previous check
+  epicsUInt32 lastStatus;                 //!< Status at the previous check
+  bool valid;                             //!< registers have been read successfully before
+  bool active;                            //!< registers changed at the last check
+  unsigned long cycle;                    //!< cycle of the poll class of the last check
+};
+
+//! @brief   Item followed at a high rate after a write
+//!
+//! After a write the written item and its related items are read with
+//! the fast-follow period until their values settled or the window expired.
+struct isegHalFollow {
+  isegHalItem* pitem;                     //!< followed item
+  double start;                           //!< time of the write
+  double until;                           //!< end of the fast-follow window
+  unsigned stable;                        //!< reads without change since the last change
+  bool changed;                           //!< value changed since the write
+};
+
+//! @brief   Group of items polled with a common period
+//!
+//! Each record is assigned to a poll class, either by the optional
+//! third option of its INP/OUT field or by the info tag "isegPollClass".
+//! Records without a poll class are polled with the class "default".
+struct isegHalPollClass {
+  std::string name;                       //!< name of the poll class
+  double period;                          //!< poll period in seconds
+  double due;                             //!< deadline of next poll
+  unsigned long cycles;                   //!< number of polls of this class
+  unsigned long overruns;                 //!< number of missed deadlines
+  unsigned long reads;                    //!< number of items read from isegHAL
+  unsigned long skipped;                  //!< number of items skipped by hierarchical polling
+  unsigned long unchanged;                //!< number of polls skipped since isegHAL had no new cycle
+  epicsUInt32 lastCycleCounter;           //!< CycleCounter of isegHAL at the previous poll
+  bool cycleCounterValid;                 //!< lastCycleCounter has been read
+  double lastSweep;                       //!< start of the last full sweep, negative if none yet
+  isegHalRegistry< isegHalItem > items;   //!< items polled in this class
+  std::map< std::string, isegHalModuleGate > modules; //!< registers of the modules of the channel items
 };
 
 //! @brief   thread monitoring set values from isegHAL
@@ -70,30 +582,234 @@ class isegHalConnectionHandler {
 //! This thread checks regulary the value of all set-parameters
 //! and updates the corresponding output-records if the values
 //! within the EPICS db and the isegHAL are out of sync.
+//! Input records are processed by scanIoRequest of their scan group,
+//! output records by their readback callback with a pending readback.
+//! There is one instance of this thread per isegHAL interface.
+//! The records are polled in poll classes with individual periods,
+//! the thread always handles the poll class which is due next.
+//! Deadlines are absolute on the monotonic clock, so the period of a
+//! poll class does not drift with the time needed to poll it.
+//! In hierarchical mode the channel items of a module are only read
+//! if the module's EventStatus or Status changed, with a periodic
+//! full sweep of all items as a safety net.
+//! A poll is skipped if the CycleCounter of isegHAL did not advance,
+//! and no poll class is polled faster than isegHAL collects its data.
+//! Items touched by a write and their related items are followed at a
+//! higher rate for a short window, independent of their poll class.
 class isegHalThread: public epicsThreadRunable {
  public:
-  isegHalThread();
+  isegHalThread( std::string const& interface );
   virtual ~isegHalThread();
   virtual void run();
   epicsThread thread;
+  isegHalWriter writer;
 
   void registerInterrupt( dbCommon* prec, devIsegHal_info_t* pinfo );
-  void cancelInterrupt( const devIsegHal_info_t* pinfo );
+  void cancelInterrupt( devIsegHal_info_t* pinfo );
 
-  inline void changeIntervall( double val ) { _pause = val; }
-  inline double getIntervall(){ return _pause; }
+  isegHalPollClass* pollClass( std::string const& name );
+  void changeIntervall( std::string const& name, double val );
+
+  isegHalItem* item( const devIsegHal_info_t* pinfo );
+  isegHalScanGroup* scanGroup( std::string const& object );
+  void snapshot( std::vector< isegHalSnapshotValue >& values ) const;
 
   inline void setDbgLvl( int dbglvl ) { _debug = dbglvl; }
+  inline void setHierarchical( bool val ) { _hierarchical = val; }
+  inline void setFullSweep( double val ) { _fullSweep = val; }
+  inline void setCycleGate( bool val ) { _cycleGate = val; }
+  inline void setLane( unsigned lane ) { _lane = lane; }
+  void setFollowWindow( double val );
+  void setFollowPeriod( double val );
+  void setFollowSettle( unsigned val );
+  inline void setDeferInit( bool val ) { _deferInit = val; }
+  inline bool deferInit() const { return _deferInit; }
+  void setRelated( std::string const& leaf, std::string const& related );
+  void follow( std::string const& object );
+  inline unsigned lane() const { return _lane; }
   inline void disable() { _run = false; }
   inline void enable() { _run = true; }
+  inline void wakeup() { _wakeup.signal(); }
+  void requestFetch();
+  void requeue( isegHalScanGroup* pgroup );
+
+  long broadcast( std::vector< std::string > const& frames, double& latency );
+  long emergency( std::string const& frame, epicsUInt64 requested );
+
+  void report( int level ) const;
+  bool statistic( std::string const& name, double& value ) const;
 
  private:
+  double now() const;
+  void poll( isegHalPollClass* pclass );
+  bool read( isegHalItem* pitem, unsigned long& coalesced );
+  void fetch();
+  void followUp();
+  bool moduleActive( isegHalPollClass* pclass, std::string const& module );
+  bool halCycleAdvanced( isegHalPollClass* pclass );
+  void dispatch();
+  long pauseCollector();
+  long resumeCollector();
+
+  typedef std::pair< double, isegHalPollClass* > deadline_t;
+
+  std::string _interface;
+  unsigned _lane;
   bool _run;
-  double _pause;
   unsigned _debug;
-  std::list< devIsegHal_info_t* > _recs;
+  bool _hierarchical;
+  double _fullSweep;
+  bool _cycleGate;
+  double _halCycle;
+  epicsUInt32 _lastCycleCounter;
+  double _lastCycleTime;
+  bool _cycleCounterValid;
+  double _followWindow;
+  double _followPeriod;
+  unsigned _followSettle;
+  double _followDue;
+  bool _deferInit;
+  epicsUInt64 _epoch;
+  mutable epicsMutex _lock;
+  epicsMutex _broadcastLock;
+  epicsMutex _collectorLock;              //!< serializes pausing and restarting the data collector
+  unsigned _paused;                       //!< number of broadcasts and emergency offs pausing the data collector
+  epicsEvent _wakeup;
+  std::map< std::string, isegHalPollClass* > _classes;
+  std::map< std::string, isegHalItem* > _items;
+  std::map< std::string, isegHalScanGroup* > _groups;
+  std::vector< isegHalScanGroup* > _pendingGroups;
+  std::vector< isegHalScanGroup* > _requeuedGroups;   //!< groups the worker could not scan
+  bool _fetchRequested;
+  std::vector< devIsegHal_info_t* > _pendingReadbacks;
+  std::map< std::string, std::vector< std::string > > _related;
+  std::vector< isegHalFollow > _followRequests;
+  std::vector< isegHalFollow > _follows;
+  std::priority_queue< deadline_t, std::vector< deadline_t >, std::greater< deadline_t > > _schedule;
+
+  // statistics
+  unsigned long _overruns;
+  unsigned long _reads;
+  unsigned long _skipped;
+  unsigned long _unchanged;
+  unsigned long _scanRequests;
+  unsigned long _readbacks;
+  unsigned long _coalesced;
+  unsigned long _deferred;
+  unsigned long _broadcasts;
+  unsigned long _broadcastFrames;
+  unsigned long _broadcastErrors;
+  unsigned long _emergencies;
+  unsigned long _emergencyErrors;
+  unsigned long _emergencyPauseErrors;    //!< emergency offs whose pause of the data collector failed
+  unsigned long _followed;
+  unsigned long _followReads;
+  unsigned long _followSettled;
+  unsigned long _followExpired;
+  unsigned long _initFetched;
+  unsigned long _initFailed;
+  double _initFetchTime;
+  epicsTimeStamp _emergencyTime;
+  isegHalHistogram _cycleTime;
+  isegHalHistogram _jitter;
+  isegHalHistogram _broadcastTime;
+  isegHalHistogram _emergencySend;
+  isegHalHistogram _emergencyWritten;
+  isegHalHistogram _followLatency;
 };
 
+//------------------------------------------------------------------------------
+//! @brief       Get polling thread of the interface used by a record
+//! @param [in]  pinfo  Address of the record's private data structure
+//------------------------------------------------------------------------------
+inline isegHalThread* pollerOf( const devIsegHal_info_t* pinfo ) {
+  return static_cast< isegHalThread* >( pinfo->ppoller );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Add an entry to the registry
+//! @param [in]  pentry  Address of the entry
+//! @return      false if the entry is already registered, otherwise true
+//------------------------------------------------------------------------------
+template< class T >
+bool isegHalRegistry< T >::add( T* pentry ) {
+  _lock.lock();
+  if( pentry->pollIndex >= 0 ) {
+    _lock.unlock();
+    return false;
+  }
+  pentry->pollIndex = _entries.size();
+  _entries.push_back( pentry );
+  epicsAtomicIncrSizeT( &_generation );
+  _lock.unlock();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Remove an entry from the registry
+//! @param [in]  pentry  Address of the entry
+//! @return      false if the entry was not registered, otherwise true
+//!
+//! The last entry of the registry is moved to the position of the
+//! removed entry.
+//------------------------------------------------------------------------------
+template< class T >
+bool isegHalRegistry< T >::remove( T* pentry ) {
+  _lock.lock();
+  long index = pentry->pollIndex;
+  if( index < 0 || (size_t)index >= _entries.size() || _entries[index] != pentry ) {
+    _lock.unlock();
+    return false;
+  }
+  _entries[index] = _entries.back();
+  _entries[index]->pollIndex = index;
+  _entries.pop_back();
+  pentry->pollIndex = -1;
+  epicsAtomicIncrSizeT( &_generation );
+  _lock.unlock();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Number of entries in the registry
+//------------------------------------------------------------------------------
+template< class T >
+size_t isegHalRegistry< T >::size() const {
+  _lock.lock();
+  size_t n = _entries.size();
+  _lock.unlock();
+  return n;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Copy of all entries in the registry
+//------------------------------------------------------------------------------
+template< class T >
+std::vector< T* > isegHalRegistry< T >::entries() const {
+  _lock.lock();
+  std::vector< T* > copy( _entries );
+  _lock.unlock();
+  return copy;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Snapshot of the registry for the polling thread
+//! @return      Reference to the snapshot
+//!
+//! The snapshot is only refreshed if the registry has been changed since
+//! the last call. If the registry is currently locked, the previous
+//! snapshot is returned and refreshed with the next call.
+//! Must only be called by the polling thread.
+//------------------------------------------------------------------------------
+template< class T >
+std::vector< T* > const& isegHalRegistry< T >::snapshot() {
+  if( _snapshotGeneration != epicsAtomicGetSizeT( &_generation ) && _lock.tryLock() ) {
+    _snapshot = _entries;
+    _snapshotGeneration = epicsAtomicGetSizeT( &_generation );
+    _lock.unlock();
+  }
+  return _snapshot;
+}
 
 #endif
 
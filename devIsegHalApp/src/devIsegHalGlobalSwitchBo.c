@@ -54,7 +54,8 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalGlobalSwitchInitRecord_bo( boRecord *prec );
-static long devIsegHalGlobalSwitchWrite_bo( dbCommon *prec, char* value ); 
+static long devIsegHalGlobalSwitchWriteDirect_bo( boRecord *prec );
+static long devIsegHalGlobalSwitchWrite_bo( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalGlobalSwitchBo = {
@@ -63,7 +64,7 @@ devIsegHal_dset_t devIsegHalGlobalSwitchBo = {
   devIsegHalInit,
   devIsegHalGlobalSwitchInitRecord_bo,
   NULL,
-  devIsegHalGlobalSwitchWrite,
+  devIsegHalGlobalSwitchWriteDirect_bo,
   NULL,
   devIsegHalGlobalSwitchWrite_bo
 };
@@ -85,31 +86,63 @@ static long devIsegHalGlobalSwitchInitRecord_bo( boRecord *prec ){
   long status = devIsegHalGlobalSwitchInit( (dbCommon*)prec, &conf );
   if( status != 0 ) return ERROR;
 
+  devIsegHal_info_t* pinfo = (devIsegHal_info_t*)prec->dpvt;
+  if( 'B' == pinfo->object[0] ) {
+    fprintf( stderr, "\033[31;1m%s: bo records only support \"@OnOff <Interface>\" and \"@Emergency <Interface>\"\033[0m\n", prec->name );
+    return ERROR;
+  }
+  if( 'E' == pinfo->object[0] ) {
+    /* prebuild the frames to clear and set the emergency off */
+    devIsegHal_value_t off, on;
+    epicsEnum16 val = prec->val;
+    off.str[0] = on.str[0] = 'E';
+    prec->val = 0;
+    status  = devIsegHalGlobalSwitchWrite_bo( (dbCommon*)prec, &off );
+    prec->val = 1;
+    status |= devIsegHalGlobalSwitchWrite_bo( (dbCommon*)prec, &on );
+    prec->val = val;
+    if( status != OK || devIsegHalEmergencyInit( (dbCommon*)prec, off.str, on.str ) != OK ) return ERROR;
+  }
+
   prec->pact = (epicsUInt8)false; /* enable record */
 
   return OK;
 }
 
+/**-----------------------------------------------------------------------------
+ * @brief   Write function of bo records
+ * @param   [in]  prec   Address of the record calling this function
+ * @return  -1 in case of error, otherwise 0
+ *
+ * Emergency off records send their prebuilt frame directly, all other
+ * records use the common broadcast path.
+ *----------------------------------------------------------------------------*/
+static long devIsegHalGlobalSwitchWriteDirect_bo( boRecord *prec ) {
+  devIsegHal_info_t* pinfo = (devIsegHal_info_t*)prec->dpvt;
+  if( pinfo->pemergency ) return devIsegHalEmergencyWrite( (dbCommon*)prec, prec->val != 0 );
+  return devIsegHalGlobalSwitchWrite( (dbCommon*)prec );
+}
+
 /**-----------------------------------------------------------------------------
  * @brief       Convert value to cstring for bo records
  * @param [in]  prec   Address of the record calling this function
- * @param [out] value  Address of cstring containing value
+ * @param [out] pval   Address of value
  * @return      -1 in case of error, otherwise 0
  *
  * Upon normal process of the record, the current contents of the VAL field
  * is converted into a cstring. If PACT is set to true (process via callback)
  * the cstring is instead parsed and its value written to VAL field.
  *----------------------------------------------------------------------------*/
-static long devIsegHalGlobalSwitchWrite_bo( dbCommon *prec, char* value ) {
+static long devIsegHalGlobalSwitchWrite_bo( dbCommon *prec, devIsegHal_value_t* pval ) {
   boRecord *pbo = (boRecord *)prec;
-  char type = value[0];
+  char type = pval->str[0];
 
   unsigned val = 0;
   if( 'O' == type )      val = ( pbo->val << 3 );
   else if( 'E' == type ) val = ( pbo->val << 5 );
   else return ERROR;
 
-  if( sprintf( value, "004#e800600100%02x", val ) < 0 ) {
+  if( sprintf( pval->str, "004#e800600100%02x", val ) < 0 ) {
     return ERROR;
   }
   return OK;
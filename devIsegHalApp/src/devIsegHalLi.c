@@ -54,7 +54,7 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalInitRecord_li( longinRecord *prec );
-static long devIsegHalRead_li( dbCommon *prec, char* value ); 
+static long devIsegHalRead_li( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalLi = {
@@ -94,18 +94,17 @@ static long devIsegHalInitRecord_li( longinRecord *prec ){
 }
 
 /**-----------------------------------------------------------------------------
- * @brief   Parse value from cstring for longin Records
+ * @brief   Read value for longin Records
  * @param   [in]  prec   Address of the record calling this function
- * @param   [in]  value  Address of cstring containing value
+ * @param   [in]  pval   Address of parsed value
  * @return  -1 in case of error, otherwise 0
  *----------------------------------------------------------------------------*/
-static long devIsegHalRead_li( dbCommon *prec, char* value ) {
+static long devIsegHalRead_li( dbCommon *prec, devIsegHal_value_t* pval ) {
   longinRecord *pli = (longinRecord*)prec;
-  epicsInt32 buffer = 0;
-  if( sscanf( value, "%d", &buffer ) != 1 ) {
+  if( !pval->valid ) {
     return ERROR;
   }
-  pli->val = buffer;
+  pli->val = (epicsInt32)pval->uval;
   return OK;
 }
 
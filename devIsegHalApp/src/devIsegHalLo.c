@@ -54,7 +54,7 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalInitRecord_lo( longoutRecord *prec );
-static long devIsegHalWrite_lo( dbCommon *prec, char* value ); 
+static long devIsegHalWrite_lo( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalLo = {
@@ -95,26 +95,25 @@ static long devIsegHalInitRecord_lo( longoutRecord *prec ){
 /**-----------------------------------------------------------------------------
  * @brief   Convert value to cstring for longout records
  * @param   [in]  prec   Address of the record calling this function
- * @param   [out] value  Address of cstring containing value
+ * @param   [out] pval   Address of value
  * @return  -1 in case of error, otherwise 0
  *
  * Upon normal process of the record, the current contents of the VAL field
  * is converted into a cstring. If PACT is set to true (process via callback)
- * the cstring is instead parsed and its value written to VAL field.
+ * the parsed value is instead written to VAL field.
  *----------------------------------------------------------------------------*/
-static long devIsegHalWrite_lo( dbCommon *prec, char* value ) {
+static long devIsegHalWrite_lo( dbCommon *prec, devIsegHal_value_t* pval ) {
   longoutRecord *plo = (longoutRecord *)prec;
 
   if( plo->pact ) {
-    epicsInt32 buffer = 0;
-    if( sscanf( value, "%d", &buffer ) != 1 ) {
+    if( !pval->valid ) {
       return ERROR;
     }
-    plo->val = buffer;
+    plo->val = (epicsInt32)pval->uval;
     return OK;
   }
 
-  if( sprintf( value, "%d", plo->val ) < 0 ) {
+  if( sprintf( pval->str, "%d", plo->val ) < 0 ) {
     return ERROR;
   }
   return OK;
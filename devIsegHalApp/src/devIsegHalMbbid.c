@@ -54,7 +54,7 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalInitRecord_mbbid( mbbiDirectRecord *prec );
-static long devIsegHalRead_mbbid( dbCommon *prec, char* value ); 
+static long devIsegHalRead_mbbid( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalMbbid = {
@@ -92,17 +92,17 @@ static long devIsegHalInitRecord_mbbid( mbbiDirectRecord *prec ){
 }
 
 /**-----------------------------------------------------------------------------
- * @brief   Parse value from cstring for mbbiDirect records
+ * @brief   Read value for mbbiDirect records
  * @param   [in]  prec   Address of the record calling this function
- * @param   [in]  value  Address of cstring containing value
+ * @param   [in]  pval   Address of parsed value
  * @return  -1 in case of error, otherwise 0
  *----------------------------------------------------------------------------*/
-static long devIsegHalRead_mbbid( dbCommon *prec, char* value ) {
+static long devIsegHalRead_mbbid( dbCommon *prec, devIsegHal_value_t* pval ) {
   mbbiDirectRecord *pmbbid = (mbbiDirectRecord *)prec;
-  epicsUInt32 buffer = 0;
-  if( sscanf( value, "%u", &buffer ) != 1 ) {
+  if( !pval->valid ) {
     return ERROR;
   }
+  epicsUInt32 buffer = pval->uval;
 
   if( pmbbid->mask ) {
     buffer &= pmbbid->mask;
@@ -0,0 +1,125 @@
+/*******************************************************************************
+ * Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+ *                    - Helmholtz-Institut Mainz
+ *
+ * This file is part of devIsegHal
+ *
+ * devIsegHal is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * devIseghal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * version 2.1.0; October 16, 2026
+ *
+*******************************************************************************/
+
+/**
+ * @file devIsegHalMbbod.c
+ * @author F.Feldbauer
+ * @date 16 October 2026
+ * @brief Device Support implementation for mbboDirect records
+ */
+
+/*_____ I N C L U D E S ______________________________________________________*/
+
+/* ANSI C includes  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* EPICS includes */
+#include <alarm.h>
+#include <dbAccess.h>
+#include <errlog.h>
+#include <epicsExport.h>
+#include <epicsTypes.h>
+#include <mbboDirectRecord.h>
+#include <recGbl.h>
+
+/* local includes */
+#include "devIsegHal.h"
+
+/*_____ D E F I N I T I O N S ________________________________________________*/
+static long devIsegHalInitRecord_mbbod( mbboDirectRecord *prec );
+static long devIsegHalWrite_mbbod( dbCommon *prec, devIsegHal_value_t* pval ); 
+
+/*_____ G L O B A L S ________________________________________________________*/
+devIsegHal_dset_t devIsegHalMbbod = {
+  7,
+  NULL,
+  devIsegHalInit,
+  devIsegHalInitRecord_mbbod,
+  NULL,
+  devIsegHalWrite,
+  NULL,
+  devIsegHalWrite_mbbod
+};
+epicsExportAddress( dset, devIsegHalMbbod );
+
+/*_____ L O C A L S __________________________________________________________*/
+
+/*_____ F U N C T I O N S ____________________________________________________*/
+
+/**-----------------------------------------------------------------------------
+ * @brief   Initialization of mbboDirect records
+ * @param   [in]  prec   Address of the record calling this function
+ * @return  In case of error return -1, otherwise return 0
+ *
+ * The bits given by MASK (or NOBT) and SHFT are written by read-modify-write
+ * of the register, the other bits are left unchanged.
+ * Without MASK the whole register is written.
+ *----------------------------------------------------------------------------*/
+static long devIsegHalInitRecord_mbbod( mbboDirectRecord *prec ){
+  prec->pact = (epicsUInt8)true; /* disable record */
+
+  prec->mask <<= prec->shft;
+  devIsegHal_rec_t conf = { &prec->out, "WR", "UI", true, prec->mask };
+  long status = devIsegHalInitRecord( (dbCommon*)prec, &conf );
+  if( status != 0 ) return ERROR;
+
+  prec->pact = (epicsUInt8)false; /* enable record */
+
+  return OK;
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Convert value to cstring for mbboDirect records
+ * @param   [in]  prec   Address of the record calling this function
+ * @param   [in]  pval   Address of value
+ * @return  -1 in case of error, otherwise 0
+ *
+ * Upon normal process of the record, the current contents of the RVAL field
+ * is converted into a cstring. If PACT is set to true (process via callback)
+ * the bits of MASK within the parsed register are instead written to the
+ * RVAL, VAL and B0 to BF fields.
+ *----------------------------------------------------------------------------*/
+static long devIsegHalWrite_mbbod( dbCommon *prec, devIsegHal_value_t* pval ) {
+  mbboDirectRecord *pmbbod = (mbboDirectRecord *)prec;
+
+  if( pmbbod->pact ) {
+    if( !pval->valid ) {
+      return ERROR;
+    }
+    epicsUInt8 *pbit = &pmbbod->b0;
+    unsigned i = 0;
+    pmbbod->rval = pval->uval;
+    pmbbod->val  = pval->uval >> pmbbod->shft;
+    for( ; i < 16; ++i ) pbit[i] = (epicsUInt8)( ( pmbbod->val >> i ) & 1 );
+    return OK;
+  }
+
+  if( sprintf( pval->str, "%u", pmbbod->rval ) < 0 ) {
+    return ERROR;
+  }
+  return OK;
+}
+
@@ -0,0 +1,387 @@
+/*******************************************************************************
+ * Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+ *                    - Helmholtz-Institut Mainz
+ *
+ * This file is part of devIsegHal
+ *
+ * devIsegHal is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * devIseghal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * version 2.1.0; October 16, 2026
+ *
+*******************************************************************************/
+
+/**
+ * @file devIsegHalParse.c
+ * @author F.Feldbauer
+ * @date 16 October 2026
+ * @brief Fast parser for the value and timestamp cstrings of isegHAL
+ *
+ * The parsers only accept the plain number formats used by isegHAL.
+ * Unlike sscanf/strtod they do not depend on the locale and do not
+ * allocate memory.
+ */
+
+/*_____ I N C L U D E S ______________________________________________________*/
+
+/* ANSI C includes  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* EPICS includes */
+#include <epicsMath.h>
+#include <epicsTime.h>
+#include <epicsTypes.h>
+
+/* local includes */
+#include "devIsegHal.h"
+#include "devIsegHalParse.h"
+
+/*_____ D E F I N I T I O N S ________________________________________________*/
+
+/* Maximum number of significant digits stored in the mantissa */
+#define MAX_DIGITS 19
+
+/*_____ G L O B A L S ________________________________________________________*/
+
+/*_____ L O C A L S __________________________________________________________*/
+
+/* Powers of ten which are exactly representable as double */
+static const epicsFloat64 pow10tab[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Nanoseconds per digit of the fractional second */
+static const epicsUInt32 nsecScale[] = {
+  1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1
+};
+
+/* Typical cstrings from isegHAL used by the benchmark */
+static const char *benchTimes[] = {
+  "1444045783.123456", "1444045783.1", "1444045784.000001", "1444045790.5",
+  "1444046012.987654", "1444046012"
+};
+static const char *benchDoubles[] = {
+  "2999.998779", "0.000000", "-1500.250000", "1.234567e-06", "5.000000e+03", "0.5"
+};
+static const char *benchUInts[] = {
+  "0", "1", "4096", "65535", "2147483648", "4294967295"
+};
+
+/*_____ F U N C T I O N S ____________________________________________________*/
+
+/**-----------------------------------------------------------------------------
+ * @brief   Skip trailing white space
+ * @param   [in]  str   Address of cstring
+ * @return  true if only white space is left in the cstring
+ *----------------------------------------------------------------------------*/
+static bool devIsegHalParseEnd( const char *str ) {
+  while( ' ' == *str || '\t' == *str || '\n' == *str || '\r' == *str ) ++str;
+  return ( 0 == *str );
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Match a word at the beginning of a cstring ignoring its case
+ * @param   [in]  str   Address of cstring
+ * @param   [in]  word  Lower case word to match
+ * @return  Length of the word if it matches, otherwise 0
+ *----------------------------------------------------------------------------*/
+static size_t devIsegHalParseWord( const char *str, const char *word ) {
+  size_t i = 0;
+  for( ; word[i]; ++i ) {
+    char c = str[i];
+    if( c >= 'A' && c <= 'Z' ) c += 'a' - 'A';
+    if( c != word[i] ) return 0;
+  }
+  return i;
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Parse floating point value from cstring
+ * @param   [in]  str   Address of cstring containing value
+ * @param   [out] pval  Address of parsed value
+ * @return  -1 in case of error, otherwise 0
+ *
+ * Accepts an optional sign, decimal digits with an optional decimal point
+ * and an optional exponent. For up to 15 significant digits and exponents
+ * up to 22 the result is exact, otherwise it may differ in the last bit.
+ * Like sscanf, "nan", "inf" and "infinity" are accepted in any case.
+ *----------------------------------------------------------------------------*/
+long devIsegHalParseDouble( const char *str, epicsFloat64 *pval ) {
+  const char *p = str;
+  bool negative = false;
+  epicsUInt64 mantissa = 0;
+  int digits = 0;
+  int exp10 = 0;
+  bool any = false;
+
+  if( '-' == *p ) { negative = true; ++p; }
+  else if( '+' == *p ) ++p;
+
+  if( 'i' == *p || 'I' == *p || 'n' == *p || 'N' == *p ) {
+    size_t n = devIsegHalParseWord( p, "infinity" );
+    if( !n ) n = devIsegHalParseWord( p, "inf" );
+    if( n ) {
+      if( !devIsegHalParseEnd( p + n ) ) return ERROR;
+      *pval = negative ? -epicsINF : epicsINF;
+      return OK;
+    }
+    n = devIsegHalParseWord( p, "nan" );
+    if( !n || !devIsegHalParseEnd( p + n ) ) return ERROR;
+    *pval = negative ? -epicsNAN : epicsNAN;
+    return OK;
+  }
+
+  for( ; *p >= '0' && *p <= '9'; ++p ) {
+    any = true;
+    if( digits < MAX_DIGITS ) {
+      mantissa = mantissa * 10 + ( *p - '0' );
+      if( mantissa ) ++digits;
+    } else {
+      ++exp10;
+    }
+  }
+  if( '.' == *p ) {
+    for( ++p; *p >= '0' && *p <= '9'; ++p ) {
+      any = true;
+      if( digits < MAX_DIGITS ) {
+        mantissa = mantissa * 10 + ( *p - '0' );
+        if( mantissa ) ++digits;
+        --exp10;
+      }
+    }
+  }
+  if( !any ) return ERROR;
+
+  if( 'e' == *p || 'E' == *p ) {
+    bool expNegative = false;
+    int exponent = 0;
+    ++p;
+    if( '-' == *p ) { expNegative = true; ++p; }
+    else if( '+' == *p ) ++p;
+    if( *p < '0' || *p > '9' ) return ERROR;
+    for( ; *p >= '0' && *p <= '9'; ++p ) {
+      if( exponent < 10000 ) exponent = exponent * 10 + ( *p - '0' );
+    }
+    exp10 += expNegative ? -exponent : exponent;
+  }
+  if( !devIsegHalParseEnd( p ) ) return ERROR;
+
+  epicsFloat64 value = (epicsFloat64)mantissa;
+  if( 0 == mantissa ) {
+    value = 0.;
+  } else if( exp10 >= -22 && exp10 <= 22 ) {
+    value = ( exp10 < 0 ) ? value / pow10tab[-exp10] : value * pow10tab[exp10];
+  } else {
+    value *= pow( 10., exp10 );
+  }
+
+  *pval = negative ? -value : value;
+  return OK;
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Parse unsigned integer value from cstring
+ * @param   [in]  str   Address of cstring containing value
+ * @param   [out] pval  Address of parsed value
+ * @return  -1 in case of error, otherwise 0
+ *
+ * Accepts an optional '+' sign followed by decimal digits.
+ *----------------------------------------------------------------------------*/
+long devIsegHalParseUInt32( const char *str, epicsUInt32 *pval ) {
+  const char *p = str;
+  epicsUInt64 value = 0;
+
+  if( '+' == *p ) ++p;
+  if( *p < '0' || *p > '9' ) return ERROR;
+  for( ; *p >= '0' && *p <= '9'; ++p ) {
+    value = value * 10 + ( *p - '0' );
+    if( value > 0xffffffffULL ) return ERROR;
+  }
+  if( !devIsegHalParseEnd( p ) ) return ERROR;
+
+  *pval = (epicsUInt32)value;
+  return OK;
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Get data type of an isegHAL item
+ * @param   [in]  type   DataType property of the item
+ * @return  Data type used for parsing the value cstring
+ *----------------------------------------------------------------------------*/
+devIsegHal_type_t devIsegHalParseType( const char *type ) {
+  if( 0 == strcmp( type, "R4" ) ) return devIsegHalTypeDouble;
+  if( 0 == strncmp( type, "UI", 2 ) || 0 == strcmp( type, "BOOL" ) ) return devIsegHalTypeUInt;
+  return devIsegHalTypeString;
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Parse value cstring into typed value
+ * @param   [in,out] pval  Address of value, str and type have to be set
+ * @return  -1 in case of error, otherwise 0
+ *----------------------------------------------------------------------------*/
+long devIsegHalParseValue( devIsegHal_value_t *pval ) {
+  long status = OK;
+  switch( pval->type ) {
+    case devIsegHalTypeDouble:
+      status = devIsegHalParseDouble( pval->str, &pval->dval );
+      break;
+    case devIsegHalTypeUInt:
+      status = devIsegHalParseUInt32( pval->str, &pval->uval );
+      break;
+    default:
+      break;
+  }
+  pval->valid = ( OK == status );
+  return status;
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Compare two typed values
+ * @param   [in]  pa   Address of first value
+ * @param   [in]  pb   Address of second value
+ * @return  true if both values are valid and equal
+ *
+ * Numbers are compared by value, only strings are compared as cstrings.
+ *----------------------------------------------------------------------------*/
+bool devIsegHalValueEqual( const devIsegHal_value_t *pa, const devIsegHal_value_t *pb ) {
+  if( !pa->valid || !pb->valid || pa->type != pb->type ) return false;
+  switch( pa->type ) {
+    case devIsegHalTypeDouble: return ( pa->dval == pb->dval );
+    case devIsegHalTypeUInt:   return ( pa->uval == pb->uval );
+    default:                   return ( 0 == strncmp( pa->str, pb->str, VALUE_SIZE ) );
+  }
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Copy a typed value
+ * @param   [out] pdest  Address of destination
+ * @param   [in]  psrc   Address of source
+ *
+ * The cstring is copied as well, since it is printed in error messages
+ * and written to the snapshot file for all types.
+ *----------------------------------------------------------------------------*/
+void devIsegHalCopyValue( devIsegHal_value_t *pdest, const devIsegHal_value_t *psrc ) {
+  pdest->type  = psrc->type;
+  pdest->valid = psrc->valid;
+  pdest->dval  = psrc->dval;
+  pdest->uval  = psrc->uval;
+  memcpy( pdest->str, psrc->str, VALUE_SIZE );
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Parse timestamp from cstring
+ * @param   [in]  str   Address of cstring containing timestamp
+ * @param   [out] pts   Address of EPICS timestamp
+ * @return  -1 in case of error, otherwise 0
+ *
+ * isegHAL timestamps are POSIX seconds with an optional fractional part,
+ * e.g. "1444045783.123456". The fraction is scaled by its number of digits,
+ * digits beyond nanoseconds are ignored.
+ *----------------------------------------------------------------------------*/
+long devIsegHalParseTime( const char *str, epicsTimeStamp *pts ) {
+  const char *p = str;
+  epicsUInt64 seconds = 0;
+  epicsUInt32 fraction = 0;
+  int digits = 0;
+
+  if( *p < '0' || *p > '9' ) return ERROR;
+  for( ; *p >= '0' && *p <= '9'; ++p ) {
+    seconds = seconds * 10 + ( *p - '0' );
+    if( seconds > 0xffffffffULL ) return ERROR;
+  }
+  if( '.' == *p ) {
+    for( ++p; *p >= '0' && *p <= '9'; ++p ) {
+      if( digits < 9 ) {
+        fraction = fraction * 10 + ( *p - '0' );
+        ++digits;
+      }
+    }
+  }
+  if( !devIsegHalParseEnd( p ) ) return ERROR;
+  if( seconds < POSIX_TIME_AT_EPICS_EPOCH ) return ERROR;
+
+  pts->secPastEpoch = (epicsUInt32)( seconds - POSIX_TIME_AT_EPICS_EPOCH );
+  pts->nsec = fraction * nsecScale[digits];
+  return OK;
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Compare the parsers with sscanf
+ * @param   [in]  loops  Number of passes through the cstrings
+ *
+ * Parses a set of typical isegHAL cstrings with sscanf and with the
+ * parsers of this file and prints the mean time per cstring.
+ *----------------------------------------------------------------------------*/
+void devIsegHalParseBenchmark( unsigned loops ) {
+  const size_t nTimes = sizeof( benchTimes ) / sizeof( benchTimes[0] );
+  const size_t nDoubles = sizeof( benchDoubles ) / sizeof( benchDoubles[0] );
+  const size_t nUInts = sizeof( benchUInts ) / sizeof( benchUInts[0] );
+  epicsTimeStamp ts;
+  epicsFloat64 dval = 0.;
+  epicsUInt32 uval = 0;
+  epicsUInt32 seconds = 0;
+  epicsUInt32 fraction = 0;
+  unsigned errors = 0;
+  unsigned i;
+  size_t j;
+
+  if( 0 == loops ) loops = 100000;
+  printf( "Parsing typical isegHAL cstrings %u times (ns per cstring):\n", loops );
+  printf( "  %-10s %10s %10s\n", "Format", "sscanf", "devIsegHal" );
+
+  /* Timestamps */
+  epicsUInt64 t0 = epicsMonotonicGet();
+  for( i = 0; i < loops; ++i )
+    for( j = 0; j < nTimes; ++j )
+      if( sscanf( benchTimes[j], "%u.%u", &seconds, &fraction ) < 1 ) ++errors;
+  epicsUInt64 t1 = epicsMonotonicGet();
+  for( i = 0; i < loops; ++i )
+    for( j = 0; j < nTimes; ++j )
+      if( devIsegHalParseTime( benchTimes[j], &ts ) != OK ) ++errors;
+  epicsUInt64 t2 = epicsMonotonicGet();
+  printf( "  %-10s %10.1lf %10.1lf\n", "Timestamp",
+          (double)( t1 - t0 ) / ( loops * nTimes ), (double)( t2 - t1 ) / ( loops * nTimes ) );
+
+  /* R4 values */
+  t0 = epicsMonotonicGet();
+  for( i = 0; i < loops; ++i )
+    for( j = 0; j < nDoubles; ++j )
+      if( sscanf( benchDoubles[j], "%lf", &dval ) != 1 ) ++errors;
+  t1 = epicsMonotonicGet();
+  for( i = 0; i < loops; ++i )
+    for( j = 0; j < nDoubles; ++j )
+      if( devIsegHalParseDouble( benchDoubles[j], &dval ) != OK ) ++errors;
+  t2 = epicsMonotonicGet();
+  printf( "  %-10s %10.1lf %10.1lf\n", "R4",
+          (double)( t1 - t0 ) / ( loops * nDoubles ), (double)( t2 - t1 ) / ( loops * nDoubles ) );
+
+  /* UI4 and BOOL values */
+  t0 = epicsMonotonicGet();
+  for( i = 0; i < loops; ++i )
+    for( j = 0; j < nUInts; ++j )
+      if( sscanf( benchUInts[j], "%u", &uval ) != 1 ) ++errors;
+  t1 = epicsMonotonicGet();
+  for( i = 0; i < loops; ++i )
+    for( j = 0; j < nUInts; ++j )
+      if( devIsegHalParseUInt32( benchUInts[j], &uval ) != OK ) ++errors;
+  t2 = epicsMonotonicGet();
+  printf( "  %-10s %10.1lf %10.1lf\n", "UI4/BOOL",
+          (double)( t1 - t0 ) / ( loops * nUInts ), (double)( t2 - t1 ) / ( loops * nUInts ) );
+
+  if( errors ) printf( "  %u cstrings could not be parsed\n", errors );
+}
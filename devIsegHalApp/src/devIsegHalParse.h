@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+ *                    - Helmholtz-Institut Mainz
+ *                    iseg Spezialelektronik GmbH
+ *
+ * This file is part of devIsegHal
+ *
+ * devIsegHal is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * devIseghal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * version 2.1.0; October 16, 2026
+ *
+*******************************************************************************/
+
+#ifndef devIsegHalParse_H
+#define devIsegHalParse_H
+
+/*_____ I N C L U D E S ______________________________________________________*/
+
+/* ANSI C/C++ includes  */
+#include <stdbool.h>
+
+/* EPICS includes */
+#include <epicsTime.h>
+#include <epicsTypes.h>
+#include <shareLib.h>
+
+/* local includes */
+#include "devIsegHal.h"
+
+/*_____ D E F I N I T I O N S ________________________________________________*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+epicsShareExtern long devIsegHalParseDouble( const char *str, epicsFloat64 *pval );
+epicsShareExtern long devIsegHalParseUInt32( const char *str, epicsUInt32 *pval );
+epicsShareExtern long devIsegHalParseTime( const char *str, epicsTimeStamp *pts );
+epicsShareExtern devIsegHal_type_t devIsegHalParseType( const char *type );
+epicsShareExtern long devIsegHalParseValue( devIsegHal_value_t *pval );
+epicsShareExtern bool devIsegHalValueEqual( const devIsegHal_value_t *pa, const devIsegHal_value_t *pb );
+epicsShareExtern void devIsegHalCopyValue( devIsegHal_value_t *pdest, const devIsegHal_value_t *psrc );
+epicsShareExtern void devIsegHalParseBenchmark( unsigned loops );
+
+#ifdef __cplusplus
+} //extern "C"
+#endif /* cplusplus */
+
+#endif
@@ -0,0 +1,181 @@
+/*******************************************************************************
+ * Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+ *                    - Helmholtz-Institut Mainz
+ *
+ * This file is part of devIsegHal
+ *
+ * devIsegHal is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * devIseghal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * version 2.1.0; October 16, 2026
+ *
+*******************************************************************************/
+
+/**
+ * @file devIsegHalParseTest.c
+ * @author F.Feldbauer
+ * @date 16 October 2026
+ * @brief Unit test and benchmark of the cstring parsers
+ *
+ * The parsers are checked against sscanf on cstrings as returned by
+ * isegHAL, afterwards the benchmark compares their speed.
+ */
+
+/*_____ I N C L U D E S ______________________________________________________*/
+
+/* ANSI C includes  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* EPICS includes */
+#include <epicsMath.h>
+#include <epicsTime.h>
+#include <epicsTypes.h>
+#include <epicsUnitTest.h>
+#include <testMain.h>
+
+/* local includes */
+#include "devIsegHalParse.h"
+
+/*_____ L O C A L S __________________________________________________________*/
+
+/* Timestamps (timeStampLastChanged) as returned by isegHAL */
+static const char *corpusTimes[] = {
+  "1444045783.123456", "1444045783.1", "1444045784.000001", "1444045790.5",
+  "1444046012.987654", "1444046012", "1444046012.0", "1444046012.999999999",
+  "1444046012.1234567891", "1700000000.05", "631152000.25"
+};
+
+/* Values of R4 items as returned by isegHAL */
+static const char *corpusDoubles[] = {
+  "2999.998779", "0.000000", "-1500.250000", "1.234567e-06", "5.000000e+03", "0.5",
+  "-0.000001", "1e22", "6000", "+12.5", "3.000000E-03", "1234567.890123", ".25",
+  "nan", "NaN", "-nan", "inf", "-inf", "+INF", "Infinity", "-infinity"
+};
+
+/* Values of UI1, UI4 and BOOL items as returned by isegHAL */
+static const char *corpusUInts[] = {
+  "0", "1", "4096", "65535", "2147483648", "4294967295", "+7", "00012"
+};
+
+/* Cstrings the parsers have to reject */
+static const char *invalidTimes[] = {
+  "", "abc", "1444045783.1x", "-1444045783", "99999999999", "631151999"
+};
+static const char *invalidDoubles[] = {
+  "", "-", ".", "abc", "1.5x", "1e", "1.0 2", "in", "infinit", "nanx", "inf 1"
+};
+static const char *invalidUInts[] = {
+  "", "-1", "abc", "12x", "4294967296", "1.5"
+};
+
+#define NELEMENTS( a ) ( sizeof( a ) / sizeof( a[0] ) )
+
+/*_____ F U N C T I O N S ____________________________________________________*/
+
+/**-----------------------------------------------------------------------------
+ * @brief   Compare timestamps with sscanf
+ *
+ * The reference pads the fraction to nine digits, so e.g. ".1" has to
+ * result in 100000000 ns.
+ *----------------------------------------------------------------------------*/
+static void testTimes( void ) {
+  size_t i;
+  epicsTimeStamp ts;
+
+  for( i = 0; i < NELEMENTS( corpusTimes ); ++i ) {
+    unsigned seconds = 0;
+    char digits[10] = "";
+    char fraction[10] = "000000000";
+    sscanf( corpusTimes[i], "%u.%9[0-9]", &seconds, digits );
+    memcpy( fraction, digits, strlen( digits ) );
+    ts.secPastEpoch = 0;
+    ts.nsec = 0;
+    long status = devIsegHalParseTime( corpusTimes[i], &ts );
+    testOk( OK == status
+            && ts.secPastEpoch == seconds - POSIX_TIME_AT_EPICS_EPOCH
+            && ts.nsec == strtoul( fraction, NULL, 10 ),
+            "Timestamp '%s': %u.%09u", corpusTimes[i], ts.secPastEpoch, ts.nsec );
+  }
+
+  devIsegHalParseTime( "1444045783.1", &ts );
+  testOk( 100000000 == ts.nsec, "Fraction '.1' scaled to 100000000 ns" );
+  devIsegHalParseTime( "1444045783.000001", &ts );
+  testOk( 1000 == ts.nsec, "Fraction '.000001' scaled to 1000 ns" );
+
+  for( i = 0; i < NELEMENTS( invalidTimes ); ++i ) {
+    testOk( ERROR == devIsegHalParseTime( invalidTimes[i], &ts ), "Timestamp '%s' rejected", invalidTimes[i] );
+  }
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Compare R4 values with sscanf
+ *
+ * All values of the corpus have at most 15 significant digits, so the
+ * result has to be exactly the same. NaN is only checked to be NaN.
+ *----------------------------------------------------------------------------*/
+static void testDoubles( void ) {
+  size_t i;
+  epicsFloat64 dval;
+
+  for( i = 0; i < NELEMENTS( corpusDoubles ); ++i ) {
+    double reference = 0.;
+    sscanf( corpusDoubles[i], "%lf", &reference );
+    dval = -1.;
+    long status = devIsegHalParseDouble( corpusDoubles[i], &dval );
+    testOk( OK == status && ( dval == reference || ( isnan( dval ) && isnan( reference ) ) ),
+            "R4 '%s': %.17g", corpusDoubles[i], dval );
+  }
+
+  for( i = 0; i < NELEMENTS( invalidDoubles ); ++i ) {
+    testOk( ERROR == devIsegHalParseDouble( invalidDoubles[i], &dval ), "R4 '%s' rejected", invalidDoubles[i] );
+  }
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Compare UI4 and BOOL values with sscanf
+ *----------------------------------------------------------------------------*/
+static void testUInts( void ) {
+  size_t i;
+  epicsUInt32 uval;
+
+  for( i = 0; i < NELEMENTS( corpusUInts ); ++i ) {
+    unsigned reference = 0;
+    sscanf( corpusUInts[i], "%u", &reference );
+    uval = 0xdeadbeef;
+    long status = devIsegHalParseUInt32( corpusUInts[i], &uval );
+    testOk( OK == status && uval == reference, "UI4 '%s': %u", corpusUInts[i], uval );
+  }
+
+  for( i = 0; i < NELEMENTS( invalidUInts ); ++i ) {
+    testOk( ERROR == devIsegHalParseUInt32( invalidUInts[i], &uval ), "UI4 '%s' rejected", invalidUInts[i] );
+  }
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Main function of the test
+ *
+ * The benchmark only prints the timing, it does not fail the test.
+ *----------------------------------------------------------------------------*/
+MAIN( devIsegHalParseTest ) {
+  testPlan( NELEMENTS( corpusTimes ) + 2 + NELEMENTS( invalidTimes )
+            + NELEMENTS( corpusDoubles ) + NELEMENTS( invalidDoubles )
+            + NELEMENTS( corpusUInts ) + NELEMENTS( invalidUInts ) );
+  testTimes();
+  testDoubles();
+  testUInts();
+  devIsegHalParseBenchmark( 10000 );
+  return testDone();
+}
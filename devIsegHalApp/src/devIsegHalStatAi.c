@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+ *                    - Helmholtz-Institut Mainz
+ *
+ * This file is part of devIsegHal
+ *
+ * devIsegHal is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * devIseghal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * version 2.1.0; October 16, 2026
+ *
+*******************************************************************************/
+
+/**
+ * @file devIsegHalStatAi.c
+ * @author F.Feldbauer
+ * @date 16 October 2026
+ * @brief Device Support for ai records reading statistics of the polling threads
+ */
+
+/*_____ I N C L U D E S ______________________________________________________*/
+
+/* ANSI C includes  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* EPICS includes */
+#include <aiRecord.h>
+#include <alarm.h>
+#include <dbAccess.h>
+#include <errlog.h>
+#include <epicsExport.h>
+#include <epicsTypes.h>
+#include <recGbl.h>
+
+/* local includes */
+#include "devIsegHal.h"
+
+/*_____ D E F I N I T I O N S ________________________________________________*/
+static long devIsegHalStatInitRecord_ai( aiRecord *prec );
+static long devIsegHalStatRead_ai( aiRecord *prec );
+
+/*_____ G L O B A L S ________________________________________________________*/
+devIsegHal_dset_t devIsegHalStatAi = {
+  6,
+  NULL,
+  NULL,
+  devIsegHalStatInitRecord_ai,
+  NULL,
+  devIsegHalStatRead_ai,
+  NULL,
+  NULL
+};
+epicsExportAddress( dset, devIsegHalStatAi );
+
+/*_____ L O C A L S __________________________________________________________*/
+
+/*_____ F U N C T I O N S ____________________________________________________*/
+
+/**-----------------------------------------------------------------------------
+ * @brief   Initialization of ai records
+ * @param   [in]  prec   Address of the record calling this function
+ * @return  In case of error return -1, otherwise return 0
+ *----------------------------------------------------------------------------*/
+static long devIsegHalStatInitRecord_ai( aiRecord *prec ){
+  devIsegHal_rec_t conf = { &prec->inp, "", "", false };
+  long status = devIsegHalStatInit( (dbCommon*)prec, &conf );
+  if( status != 0 ) return ERROR;
+
+  prec->linr = 0;
+  return OK;
+}
+
+/**-----------------------------------------------------------------------------
+ * @brief   Read statistic value for ai records
+ * @param   [in]  prec   Address of the record calling this function
+ * @return  -1 in case of error
+ *           2 (no conversion)
+ *----------------------------------------------------------------------------*/
+static long devIsegHalStatRead_ai( aiRecord *prec ) {
+  epicsFloat64 value = 0.;
+  if( devIsegHalStatRead( (dbCommon*)prec, &value ) != OK ) return ERROR;
+  prec->val = value;
+  prec->udf = (epicsUInt8)false;
+  return DO_NOT_CONVERT;
+}
@@ -54,7 +54,7 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalInitRecord_si( stringinRecord *prec );
-static long devIsegHalRead_si( dbCommon *prec, char* value ); 
+static long devIsegHalRead_si( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalSi = {
@@ -91,19 +91,19 @@ static long devIsegHalInitRecord_si( stringinRecord *prec ){
 }
 
 /**-----------------------------------------------------------------------------
- * @brief   Parse value from cstring for stringin records
+ * @brief   Read value for stringin records
  * @param   [in]  prec   Address of the record calling this function
- * @param   [in]  value  Address of cstring containing value
+ * @param   [in]  pval   Address of value
  * @return  -1 in case of error, otherwise 0
  *----------------------------------------------------------------------------*/
-static long devIsegHalRead_si( dbCommon *prec, char* value ) {
+static long devIsegHalRead_si( dbCommon *prec, devIsegHal_value_t* pval ) {
   stringinRecord *psi = (stringinRecord *)prec;
-  size_t valLen = strlen( value );
+  size_t valLen = strlen( pval->str );
   if( MAX_STRING_SIZE <= valLen ) {
     fprintf( stderr, "\033[31;1m%s: Value string too long, truncating! Lentgh: %lu\033[0m\n",
              psi->name, valLen );
   }
-  strncpy( psi->val, value, MAX_STRING_SIZE );
+  strncpy( psi->val, pval->str, MAX_STRING_SIZE );
   psi->val[39] = 0; // to be sure, VAL is null terminated
   return OK;
 }
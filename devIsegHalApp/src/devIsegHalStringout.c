@@ -54,7 +54,7 @@
 
 /*_____ D E F I N I T I O N S ________________________________________________*/
 static long devIsegHalInitRecord_so( stringoutRecord *prec );
-static long devIsegHalWrite_so( dbCommon *prec, char* value ); 
+static long devIsegHalWrite_so( dbCommon *prec, devIsegHal_value_t* pval ); 
 
 /*_____ G L O B A L S ________________________________________________________*/
 devIsegHal_dset_t devIsegHalSo = {
@@ -94,12 +94,12 @@ static long devIsegHalInitRecord_so( stringoutRecord *prec ){
 /**-----------------------------------------------------------------------------
  * @brief       Convert value to cstring for stringin records
  * @param [in]  prec   Address of the record calling this function
- * @param [out] value  Address of cstring containing value
+ * @param [out] pval   Address of value
  * @return      -1 in case of error, otherwise 0
  *----------------------------------------------------------------------------*/
-static long devIsegHalWrite_so( dbCommon *prec, char* value ) {
+static long devIsegHalWrite_so( dbCommon *prec, devIsegHal_value_t* pval ) {
   stringoutRecord *pso = (stringoutRecord *)prec;
-  strncpy( value, pso->val, MAX_STRING_SIZE );
+  strncpy( pval->str, pso->val, MAX_STRING_SIZE );
   return OK;
 }
 
@@ -0,0 +1,85 @@
+//******************************************************************************
+// Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+//                    - Helmholtz-Institut Mainz
+//                    iseg Spezialelektronik GmbH
+//
+// This file is part of deviseg
+//
+// deviseg is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// deviseg is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+// version 2.1.0; October 16, 2026
+//
+//******************************************************************************
+
+//! @file isegHalHistogram.cpp
+//! @author F.Feldbauer
+//! @date 16 October 2026
+//! @brief Histogram of durations
+
+//_____ I N C L U D E S ________________________________________________________
+
+// ANSI C/C++ includes
+#include <cstdio>
+
+// EPICS includes
+
+// local includes
+#include "devIsegHalClasses.hpp"
+
+//_____ D E F I N I T I O N S __________________________________________________
+
+//_____ G L O B A L S __________________________________________________________
+
+//_____ L O C A L S ____________________________________________________________
+
+//_____ F U N C T I O N S ______________________________________________________
+
+//------------------------------------------------------------------------------
+//! @brief       Reset histogram
+//------------------------------------------------------------------------------
+void isegHalHistogram::reset() {
+  for( unsigned i = 0; i < NBINS; ++i ) _bins[i] = 0;
+  _count = 0;
+  _sum   = 0.;
+  _last  = 0.;
+  _max   = 0.;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Add a value to the histogram
+//! @param [in]  val  duration in seconds
+//------------------------------------------------------------------------------
+void isegHalHistogram::add( double val ) {
+  unsigned bin = 0;
+  for( double limit = 1e-5; bin < NBINS - 1 && val >= limit; limit *= 10. ) ++bin;
+  ++_bins[bin];
+  ++_count;
+  _sum  += val;
+  _last  = val;
+  if( val > _max ) _max = val;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Print histogram
+//! @param [in]  title  Title of the histogram
+//------------------------------------------------------------------------------
+void isegHalHistogram::report( const char* title ) const {
+  static const char* labels[NBINS] = { "< 10us", "< 100us", "< 1ms", "< 10ms",
+                                       "< 100ms", "< 1s", "< 10s", ">= 10s" };
+  printf( "    %s: %lu entries, mean %.6lf s, max %.6lf s\n", title, _count, mean(), _max );
+  for( unsigned i = 0; i < NBINS; ++i ) {
+    if( _bins[i] ) printf( "      %-8s %lu\n", labels[i], _bins[i] );
+  }
+}
@@ -0,0 +1,252 @@
+//******************************************************************************
+// Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+//                    - Helmholtz-Institut Mainz
+//                    iseg Spezialelektronik GmbH
+//
+// This file is part of deviseg
+//
+// deviseg is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// deviseg is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+// version 2.1.0; October 16, 2026
+//
+//******************************************************************************
+
+//! @file isegHalPropertyCache.cpp
+//! @author F.Feldbauer
+//! @date 16 October 2026
+//! @brief Cache of the properties of the isegHAL items
+
+//_____ I N C L U D E S ________________________________________________________
+
+// ANSI C/C++ includes
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+// EPICS includes
+#include <epicsTime.h>
+
+// local includes
+#include "devIsegHalClasses.hpp"
+#include "devIsegHalParse.h"
+
+//_____ D E F I N I T I O N S __________________________________________________
+
+//_____ G L O B A L S __________________________________________________________
+
+//_____ L O C A L S ____________________________________________________________
+
+//_____ F U N C T I O N S ______________________________________________________
+
+//------------------------------------------------------------------------------
+//! @brief       Get instance of the property cache
+//! @return      Reference to the instance
+//------------------------------------------------------------------------------
+isegHalPropertyCache& isegHalPropertyCache::instance() {
+  static isegHalPropertyCache rInstance;
+  return rInstance;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       C'tor of isegHalPropertyCache
+//------------------------------------------------------------------------------
+isegHalPropertyCache::isegHalPropertyCache()
+  : _snapshotHits(0),
+    _hits(0),
+    _misses(0),
+    _uncached(0),
+    _missTime(0.),
+    _lookupTime(0.)
+{}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the property of an item
+//! @param [in]  interface  deviseg internal name of the interface handle
+//! @param [in]  object     Object name of the item
+//! @return      Property of the item
+//!
+//! Properties of channel items ("line.module.channel.item") and module
+//! items ("line.module.item") are cached, if the type of the module is known.
+//! Channel items are only served from the cache if the channel exists on
+//! the module, otherwise isegHAL is asked and rejects the item.
+//! Only properties read with quality OK are cached.
+//------------------------------------------------------------------------------
+IsegItemProperty isegHalPropertyCache::get( std::string const& interface, std::string const& object ) {
+  std::pair< std::string, std::string > id( interface, object );
+  IsegItemProperty property;
+  if( isegHalSnapshot::instance().property( interface.c_str(), object.c_str(), property ) ) {
+    _lock.lock();
+    ++_snapshotHits;
+    _objects[id] = property;
+    _lock.unlock();
+    return property;
+  }
+
+  std::string key;
+  long dots = std::count( object.begin(), object.end(), '.' );
+  if( 2 == dots || 3 == dots ) {
+    size_t module = object.find( '.', object.find( '.' ) + 1 );
+    std::string type = moduleType( interface, object.substr( 0, module ) );
+    bool exists = true;
+    if( 3 == dots ) {
+      // channels beyond the module's ChannelNumber are left to isegHAL to reject
+      size_t channel = module + 1;
+      epicsUInt32 index = 0;
+      exists = (    devIsegHalParseUInt32( object.substr( channel, object.find( '.', channel ) - channel ).c_str(), &index ) == OK
+                 && index < moduleChannels( interface, object.substr( 0, module ) ) );
+    }
+    if( !type.empty() && exists ) {
+      key = interface + " " + type + ( 3 == dots ? " channel " : " module " ) + object.substr( object.rfind( '.' ) + 1 );
+    }
+  }
+
+  if( !key.empty() ) {
+    _lock.lock();
+    std::map< std::string, IsegItemProperty >::const_iterator it = _properties.find( key );
+    if( it != _properties.end() ) {
+      property = it->second;
+      ++_hits;
+      strncpy( property.object, object.c_str(), FULLY_QUALIFIED_OBJECT_SIZE );
+      property.object[FULLY_QUALIFIED_OBJECT_SIZE - 1] = '\0';
+      _objects[id] = property;
+      _lock.unlock();
+      return property;
+    }
+    _lock.unlock();
+  }
+
+  epicsUInt64 start = epicsMonotonicGet();
+  property = iseg_getItemProperty( interface.c_str(), object.c_str() );
+  double duration = ( epicsMonotonicGet() - start ) * 1e-9;
+
+  _lock.lock();
+  bool ok = ( strcmp( property.quality, ISEG_ITEM_QUALITY_OK ) == 0 );
+  if( key.empty() || !ok ) {
+    ++_uncached;
+  } else {
+    _properties[key] = property;
+    ++_misses;
+    _missTime += duration;
+  }
+  if( ok ) _objects[id] = property;
+  _lock.unlock();
+  return property;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the properties of all items used by records
+//! @param [out] properties  Properties for the snapshot file
+//------------------------------------------------------------------------------
+void isegHalPropertyCache::snapshot( std::vector< isegHalSnapshotProperty >& properties ) const {
+  _lock.lock();
+  std::map< std::pair< std::string, std::string >, IsegItemProperty >::const_iterator it = _objects.begin();
+  for( ; it != _objects.end(); ++it ) {
+    isegHalSnapshotProperty entry;
+    memset( &entry, 0, sizeof( entry ) );
+    strncpy( entry.interface, it->first.first.c_str(), sizeof( entry.interface ) - 1 );
+    entry.property = it->second;
+    properties.push_back( entry );
+  }
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the type of a module
+//! @param [in]  interface  deviseg internal name of the interface handle
+//! @param [in]  module     Module ("line.module")
+//! @return      Article of the module, empty if unknown
+//------------------------------------------------------------------------------
+std::string isegHalPropertyCache::moduleType( std::string const& interface, std::string const& module ) {
+  std::string key = interface + " " + module;
+  _lock.lock();
+  std::map< std::string, std::string >::const_iterator it = _modules.find( key );
+  if( it != _modules.end() ) {
+    std::string type = it->second;
+    _lock.unlock();
+    return type;
+  }
+  _lock.unlock();
+
+  epicsUInt64 start = epicsMonotonicGet();
+  IsegItem item = iseg_getItem( interface.c_str(), ( module + ".Article" ).c_str() );
+  double duration = ( epicsMonotonicGet() - start ) * 1e-9;
+  std::string type;
+  if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) == 0 ) type = item.value;
+
+  _lock.lock();
+  _modules[key] = type;
+  _lookupTime += duration;
+  _lock.unlock();
+  return type;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the number of channels of a module
+//! @param [in]  interface  deviseg internal name of the interface handle
+//! @param [in]  module     Module ("line.module")
+//! @return      ChannelNumber of the module, 0 if unknown
+//------------------------------------------------------------------------------
+epicsUInt32 isegHalPropertyCache::moduleChannels( std::string const& interface, std::string const& module ) {
+  std::string key = interface + " " + module;
+  _lock.lock();
+  std::map< std::string, epicsUInt32 >::const_iterator it = _channels.find( key );
+  if( it != _channels.end() ) {
+    epicsUInt32 channels = it->second;
+    _lock.unlock();
+    return channels;
+  }
+  _lock.unlock();
+
+  epicsUInt64 start = epicsMonotonicGet();
+  IsegItem item = iseg_getItem( interface.c_str(), ( module + ".ChannelNumber" ).c_str() );
+  double duration = ( epicsMonotonicGet() - start ) * 1e-9;
+  epicsUInt32 channels = 0;
+  if(    strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0
+      || devIsegHalParseUInt32( item.value, &channels ) != OK ) channels = 0;
+
+  _lock.lock();
+  _channels[key] = channels;
+  _lookupTime += duration;
+  _lock.unlock();
+  return channels;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Print statistics of the property cache
+//! @param [in]  level   Level of detail
+//!
+//! The time saved is estimated from the mean time of reading a property
+//! from isegHAL, less the time needed to read the module types and
+//! channel numbers.
+//------------------------------------------------------------------------------
+void isegHalPropertyCache::report( int level ) const {
+  _lock.lock();
+  unsigned long requests = _snapshotHits + _hits + _misses + _uncached;
+  double saved = _misses ? _hits * _missTime / _misses - _lookupTime : 0.;
+  printf( "Item property cache: %lu properties, %lu modules, %lu hits, %lu misses, %lu uncached, %lu from snapshot\n",
+          (unsigned long)_properties.size(), (unsigned long)_modules.size(), _hits, _misses, _uncached, _snapshotHits );
+  printf( "  hit rate %.1lf %%, about %.3lf s of init time saved\n",
+          requests ? 100. * _hits / requests : 0., saved );
+  if( level > 2 ) {
+    std::map< std::string, IsegItemProperty >::const_iterator it = _properties.begin();
+    for( ; it != _properties.end(); ++it ) {
+      printf( "    %s: %s %s [%s]\n", it->first.c_str(), it->second.access, it->second.type, it->second.unit );
+    }
+  }
+  _lock.unlock();
+}
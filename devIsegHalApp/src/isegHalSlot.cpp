@@ -0,0 +1,204 @@
+//******************************************************************************
+// Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+//                    - Helmholtz-Institut Mainz
+//                    iseg Spezialelektronik GmbH
+//
+// This file is part of deviseg
+//
+// deviseg is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// deviseg is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+// version 2.1.0; October 16, 2026
+//
+//******************************************************************************
+
+//! @file isegHalSlot.cpp
+//! @author F.Feldbauer
+//! @date 16 October 2026
+//! @brief Seqlock handing the values of the items to the records
+
+//_____ I N C L U D E S ________________________________________________________
+
+// ANSI C/C++ includes
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// EPICS includes
+#include <epicsAtomic.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+
+// local includes
+#include "devIsegHalClasses.hpp"
+#include "devIsegHalParse.h"
+
+//_____ D E F I N I T I O N S __________________________________________________
+
+//_____ G L O B A L S __________________________________________________________
+
+//_____ L O C A L S ____________________________________________________________
+
+//------------------------------------------------------------------------------
+//! @brief       Name of a reader thread of the slot stress test
+//! @param [in]  index  Number of the reader
+//------------------------------------------------------------------------------
+static std::string readerName( unsigned index ) {
+  char name[32];
+  sprintf( name, "isegHALslot:%u", index );
+  return name;
+}
+
+//_____ F U N C T I O N S ______________________________________________________
+
+//------------------------------------------------------------------------------
+//! @brief       Write value and timestamp to the slot
+//! @param [in]  newValue  New value
+//! @param [in]  newTime   Timestamp of the new value
+//!
+//! Must only be called by the polling thread.
+//------------------------------------------------------------------------------
+void isegHalSlot::store( devIsegHal_value_t const& newValue, epicsTimeStamp const& newTime ) {
+  epicsAtomicIncrIntT( &seq ); // odd: write in progress
+  epicsAtomicWriteMemoryBarrier();
+  memcpy( &value, &newValue, sizeof( devIsegHal_value_t ) );
+  time = newTime;
+  epicsAtomicWriteMemoryBarrier();
+  epicsAtomicIncrIntT( &seq ); // even: slot consistent
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Read value and timestamp from the slot
+//! @param [out] pvalue  Address of the value
+//! @param [out] ptime   Address of the timestamp
+//!
+//! Retries until a copy is made without a concurrent write.
+//------------------------------------------------------------------------------
+void isegHalSlot::load( devIsegHal_value_t* pvalue, epicsTimeStamp* ptime ) const {
+  int before = 0;
+  do {
+    before = epicsAtomicGetIntT( &seq );
+    if( before & 1 ) continue; // write in progress
+    epicsAtomicReadMemoryBarrier();
+    devIsegHalCopyValue( pvalue, &value );
+    *ptime = time;
+    epicsAtomicReadMemoryBarrier();
+  } while( ( before & 1 ) || before != epicsAtomicGetIntT( &seq ) );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Stress test of the slot
+//! @param [in]  seconds  Duration of the test
+//! @param [in]  readers  Number of reader threads
+//! @return      true if all readers got consistent copies, otherwise false
+//!
+//! The calling thread stores a counter into value and timestamp of a slot
+//! as fast as possible, while the readers load it concurrently and check
+//! each copy. Results are printed.
+//------------------------------------------------------------------------------
+bool isegHalSlot::hammer( double seconds, unsigned readers ) {
+  isegHalSlot slot;
+  slot.seq = 0;
+  memset( &slot.value, 0, sizeof( devIsegHal_value_t ) );
+  slot.value.type  = devIsegHalTypeString;
+  slot.value.valid = true;
+  strcpy( slot.value.str, "0" );
+  slot.time.secPastEpoch = 0;
+  slot.time.nsec = 0;
+
+  std::vector< isegHalSlotReader* > threads;
+  for( unsigned i = 0; i < readers; ++i ) {
+    isegHalSlotReader* preader = new isegHalSlotReader( slot, i );
+    preader->thread.start();
+    threads.push_back( preader );
+  }
+
+  devIsegHal_value_t value = slot.value;
+  epicsTimeStamp time;
+  epicsUInt32 stores = 0;
+  epicsUInt64 start = epicsMonotonicGet();
+  epicsUInt64 end = start + (epicsUInt64)( seconds * 1e9 );
+  while( epicsMonotonicGet() < end ) {
+    // all fields of a store carry the same counter
+    for( unsigned i = 0; i < 1000; ++i ) {
+      ++stores;
+      value.dval = stores;
+      value.uval = stores;
+      sprintf( value.str, "%u", stores );
+      time.secPastEpoch = stores;
+      time.nsec = stores % 1000000000u;
+      slot.store( value, time );
+    }
+  }
+
+  bool ok = true;
+  unsigned long loads = 0;
+  std::vector< isegHalSlotReader* >::iterator it = threads.begin();
+  for( ; it != threads.end(); ++it ) epicsAtomicSetIntT( &(*it)->stop, 1 );
+  for( it = threads.begin(); it != threads.end(); ++it ) {
+    (*it)->done.wait();
+    loads += (*it)->loads;
+    if( (*it)->torn || (*it)->backwards ) {
+      fprintf( stderr, "\033[31;1mReader %lu: %lu of %lu copies torn, %lu going backwards\033[0m\n",
+               (unsigned long)( it - threads.begin() ), (*it)->torn, (*it)->loads, (*it)->backwards );
+      ok = false;
+    }
+    delete *it;
+  }
+  printf( "isegHalSlot: %u stores and %lu loads by %u readers in %.3lf s: %s\n",
+          stores, loads, readers, ( epicsMonotonicGet() - start ) * 1e-9,
+          ok ? "all copies consistent" : "\033[31;1mFAILED\033[0m" );
+  return ok;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       C'tor of isegHalSlotReader
+//! @param [in]  slot   Slot to read
+//! @param [in]  index  Number of the reader
+//------------------------------------------------------------------------------
+isegHalSlotReader::isegHalSlotReader( isegHalSlot const& slot, unsigned index )
+  : thread( *this, readerName( index ).c_str(), epicsThreadGetStackSize( epicsThreadStackSmall ),
+            epicsThreadPriorityLow ),
+    stop(0),
+    loads(0),
+    torn(0),
+    backwards(0),
+    _slot( slot )
+{}
+
+//------------------------------------------------------------------------------
+//! @brief       Run operation of the reader thread
+//------------------------------------------------------------------------------
+void isegHalSlotReader::run() {
+  devIsegHal_value_t value;
+  epicsTimeStamp time;
+  epicsUInt32 last = 0;
+  while( !epicsAtomicGetIntT( &stop ) ) {
+    _slot.load( &value, &time );
+    ++loads;
+    epicsUInt32 counter = time.secPastEpoch;
+    if(    value.uval != counter
+        || (epicsUInt32)value.dval != counter
+        || time.nsec != counter % 1000000000u
+        || strtoul( value.str, NULL, 10 ) != counter ) {
+      ++torn;
+      continue;
+    }
+    if( counter < last ) ++backwards;
+    last = counter;
+  }
+  done.signal();
+}
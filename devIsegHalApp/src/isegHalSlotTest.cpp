@@ -0,0 +1,86 @@
+//******************************************************************************
+// Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+//                    - Helmholtz-Institut Mainz
+//                    iseg Spezialelektronik GmbH
+//
+// This file is part of deviseg
+//
+// deviseg is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// deviseg is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+// version 2.1.0; October 16, 2026
+//
+//******************************************************************************
+
+//! @file isegHalSlotTest.cpp
+//! @author F.Feldbauer
+//! @date 16 October 2026
+//! @brief Unit test of the seqlock handing values to the records
+
+//_____ I N C L U D E S ________________________________________________________
+
+// ANSI C/C++ includes
+#include <cstring>
+
+// EPICS includes
+#include <epicsUnitTest.h>
+#include <testMain.h>
+
+// local includes
+#include "devIsegHalClasses.hpp"
+
+//_____ F U N C T I O N S ______________________________________________________
+
+//------------------------------------------------------------------------------
+//! @brief       A single store is loaded unchanged
+//------------------------------------------------------------------------------
+static void testStoreLoad() {
+  isegHalSlot slot;
+  slot.seq = 0;
+  memset( &slot.value, 0, sizeof( devIsegHal_value_t ) );
+
+  devIsegHal_value_t value;
+  memset( &value, 0, sizeof( devIsegHal_value_t ) );
+  value.type  = devIsegHalTypeString;
+  value.valid = true;
+  value.dval  = 42.;
+  value.uval  = 42;
+  strcpy( value.str, "42" );
+  epicsTimeStamp time;
+  time.secPastEpoch = 42;
+  time.nsec = 100000000;
+  slot.store( value, time );
+
+  devIsegHal_value_t loaded;
+  epicsTimeStamp loadedTime;
+  slot.load( &loaded, &loadedTime );
+  testOk( 2 == slot.seq, "Sequence counter even after one store" );
+  testOk( loaded.valid && 42 == loaded.uval && 42. == loaded.dval && 0 == strcmp( loaded.str, "42" ),
+          "Value loaded as stored" );
+  testOk( 42 == loadedTime.secPastEpoch && 100000000 == loadedTime.nsec, "Timestamp loaded as stored" );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Main function of the test
+//!
+//! The stress test fails if any reader gets a torn copy or a copy older
+//! than the previous one.
+//------------------------------------------------------------------------------
+MAIN( isegHalSlotTest ) {
+  testPlan( 5 );
+  testStoreLoad();
+  testOk( isegHalSlot::hammer( 1., 1 ), "One reader: no torn or backwards copies" );
+  testOk( isegHalSlot::hammer( 2., 4 ), "Four readers: no torn or backwards copies" );
+  return testDone();
+}
@@ -0,0 +1,384 @@
+//******************************************************************************
+// Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+//                    - Helmholtz-Institut Mainz
+//                    iseg Spezialelektronik GmbH
+//
+// This file is part of deviseg
+//
+// deviseg is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// deviseg is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+// version 2.1.0; October 16, 2026
+//
+//******************************************************************************
+
+//! @file isegHalSnapshot.cpp
+//! @author F.Feldbauer
+//! @date 16 October 2026
+//! @brief Snapshot file of item properties and values
+
+//_____ I N C L U D E S ________________________________________________________
+
+// ANSI C/C++ includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// EPICS includes
+#include <epicsExit.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+
+// local includes
+#include "devIsegHalClasses.hpp"
+
+//_____ D E F I N I T I O N S __________________________________________________
+
+//_____ G L O B A L S __________________________________________________________
+
+//_____ L O C A L S ____________________________________________________________
+
+//! Version of the format of the snapshot file
+static const epicsUInt32 snapshotVersion = 1;
+
+//------------------------------------------------------------------------------
+//! @brief       Order of the entries of the snapshot file
+//! @param [in]  interface  Interface of the first entry
+//! @param [in]  object     Object of the first entry
+//! @param [in]  rinterface Interface of the second entry
+//! @param [in]  robject    Object of the second entry
+//! @return      true if the first entry is sorted before the second
+//------------------------------------------------------------------------------
+static inline bool snapshotLess( const char* interface, const char* object,
+                                 const char* rinterface, const char* robject ) {
+  int cmp = strncmp( interface, rinterface, 20 );
+  if( cmp != 0 ) return cmp < 0;
+  return strncmp( object, robject, FULLY_QUALIFIED_OBJECT_SIZE ) < 0;
+}
+
+static bool operator<( isegHalSnapshotProperty const& lhs, isegHalSnapshotProperty const& rhs ) {
+  return snapshotLess( lhs.interface, lhs.property.object, rhs.interface, rhs.property.object );
+}
+
+static bool operator<( isegHalSnapshotValue const& lhs, isegHalSnapshotValue const& rhs ) {
+  return snapshotLess( lhs.interface, lhs.object, rhs.interface, rhs.object );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Save the snapshot file at exit
+//! @param [in]  arg  unused
+//------------------------------------------------------------------------------
+static void snapshotAtExit( void* arg ) {
+  isegHalSnapshot::instance().save();
+}
+
+//_____ F U N C T I O N S ______________________________________________________
+
+//------------------------------------------------------------------------------
+//! @brief       Get instance of the snapshot file
+//! @return      Reference to the instance
+//------------------------------------------------------------------------------
+isegHalSnapshot& isegHalSnapshot::instance() {
+  static isegHalSnapshot rInstance;
+  return rInstance;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       C'tor of isegHalSnapshot
+//------------------------------------------------------------------------------
+isegHalSnapshot::isegHalSnapshot()
+  : _period( 0. ),
+    _armed( false ),
+    _pthread( NULL ),
+    _pmap( NULL ),
+    _size( 0 ),
+    _pheader( NULL ),
+    _pproperties( NULL ),
+    _pvalues( NULL ),
+    _loadedProperties(0),
+    _loadedValues(0),
+    _propertyHits(0),
+    _valueHits(0),
+    _saves(0),
+    _errors(0),
+    _saveTime(0.)
+{
+  _loaded.secPastEpoch = 0;
+  _loaded.nsec = 0;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Run operation of the thread writing the snapshot periodically
+//------------------------------------------------------------------------------
+void isegHalSnapshot::run() {
+  while( true ) {
+    _event.wait( _period );
+    save();
+  }
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Configure the snapshot file
+//! @param [in]  file    Path of the snapshot file
+//! @param [in]  period  Period in seconds of writing the snapshot, 0 to write it only at exit
+//! @return      false if the snapshot file is already configured, otherwise true
+//!
+//! An existing snapshot file is loaded, so it must be configured before
+//! the records are loaded.
+//------------------------------------------------------------------------------
+bool isegHalSnapshot::configure( std::string const& file, double period ) {
+  _lock.lock();
+  if( !_file.empty() ) {
+    _lock.unlock();
+    return false;
+  }
+  _file   = file;
+  _period = period;
+  load();
+  _lock.unlock();
+
+  epicsAtExit( snapshotAtExit, NULL );
+  if( _period > 0. ) {
+    _pthread = new epicsThread( *this, "isegHALsnapshot", epicsThreadGetStackSize( epicsThreadStackSmall ),
+                                epicsThreadPriorityLow );
+    _pthread->start();
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Map the snapshot file into memory
+//! @return      false if there is no valid snapshot file, otherwise true
+//!
+//! The file is only used if it was written by the same version of
+//! devIsegHal, as the entries are read without conversion.
+//------------------------------------------------------------------------------
+bool isegHalSnapshot::load() {
+  int fd = open( _file.c_str(), O_RDONLY );
+  if( fd < 0 ) {
+    printf( "No snapshot file '%s', records are initialized from isegHAL\n", _file.c_str() );
+    return false;
+  }
+  struct stat st;
+  if( fstat( fd, &st ) != 0 || (size_t)st.st_size < sizeof( isegHalSnapshotHeader ) ) {
+    close( fd );
+    fprintf( stderr, "\033[31;1mInvalid snapshot file '%s'\033[0m\n", _file.c_str() );
+    return false;
+  }
+  void* pmap = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+  close( fd );
+  if( MAP_FAILED == pmap ) {
+    fprintf( stderr, "\033[31;1mCannot map snapshot file '%s': %s\033[0m\n", _file.c_str(), strerror( errno ) );
+    return false;
+  }
+
+  const isegHalSnapshotHeader* pheader = static_cast< const isegHalSnapshotHeader* >( pmap );
+  size_t expected = sizeof( isegHalSnapshotHeader )
+                  + (size_t)pheader->properties * sizeof( isegHalSnapshotProperty )
+                  + (size_t)pheader->values * sizeof( isegHalSnapshotValue );
+  if(    memcmp( pheader->magic, "ISEGSNAP", sizeof( pheader->magic ) ) != 0
+      || pheader->version != snapshotVersion
+      || pheader->propertySize != sizeof( isegHalSnapshotProperty )
+      || pheader->valueSize != sizeof( isegHalSnapshotValue )
+      || expected != (size_t)st.st_size ) {
+    munmap( pmap, st.st_size );
+    fprintf( stderr, "\033[31;1mSnapshot file '%s' is invalid or of another version, ignoring it\033[0m\n",
+             _file.c_str() );
+    return false;
+  }
+
+  _pmap        = pmap;
+  _size        = st.st_size;
+  _pheader     = pheader;
+  _pproperties = reinterpret_cast< const isegHalSnapshotProperty* >( pheader + 1 );
+  _pvalues     = reinterpret_cast< const isegHalSnapshotValue* >( _pproperties + pheader->properties );
+  _loaded      = pheader->time;
+  _loadedProperties = pheader->properties;
+  _loadedValues     = pheader->values;
+
+  char time[40];
+  epicsTimeToStrftime( time, sizeof( time ), "%Y-%m-%d %H:%M:%S", &_loaded );
+  printf( "Loaded snapshot file '%s' of %s: %lu properties, %lu values\n",
+          _file.c_str(), time, _loadedProperties, _loadedValues );
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Unmap the snapshot file
+//------------------------------------------------------------------------------
+void isegHalSnapshot::unmap() {
+  if( _pmap ) munmap( _pmap, _size );
+  _pmap        = NULL;
+  _size        = 0;
+  _pheader     = NULL;
+  _pproperties = NULL;
+  _pvalues     = NULL;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the property of an item from the snapshot file
+//! @param [in]  interface  Interface name for isegHAL
+//! @param [in]  object     Object name for isegHAL
+//! @param [out] property   Property of the item
+//! @return      true if the item was found, otherwise false
+//------------------------------------------------------------------------------
+bool isegHalSnapshot::property( const char* interface, const char* object, IsegItemProperty& property ) {
+  isegHalSnapshotProperty key;
+  memset( &key, 0, sizeof( key ) );
+  strncpy( key.interface, interface, sizeof( key.interface ) - 1 );
+  strncpy( key.property.object, object, FULLY_QUALIFIED_OBJECT_SIZE - 1 );
+
+  _lock.lock();
+  if( !_pheader ) {
+    _lock.unlock();
+    return false;
+  }
+  const isegHalSnapshotProperty* end = _pproperties + _pheader->properties;
+  const isegHalSnapshotProperty* it  = std::lower_bound( _pproperties, end, key );
+  bool found = ( it != end && !( key < *it ) );
+  if( found ) {
+    property = it->property;
+    ++_propertyHits;
+  }
+  _lock.unlock();
+  return found;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the last value of an item from the snapshot file
+//! @param [in]  interface  Interface name for isegHAL
+//! @param [in]  object     Object name for isegHAL
+//! @param [out] value      Value cstring, VALUE_SIZE characters
+//! @param [out] time       Timestamp of last change
+//! @return      true if the item was found, otherwise false
+//------------------------------------------------------------------------------
+bool isegHalSnapshot::value( const char* interface, const char* object, char* value, epicsTimeStamp& time ) {
+  isegHalSnapshotValue key;
+  memset( &key, 0, sizeof( key ) );
+  strncpy( key.interface, interface, sizeof( key.interface ) - 1 );
+  strncpy( key.object, object, FULLY_QUALIFIED_OBJECT_SIZE - 1 );
+
+  _lock.lock();
+  if( !_pheader ) {
+    _lock.unlock();
+    return false;
+  }
+  const isegHalSnapshotValue* end = _pvalues + _pheader->values;
+  const isegHalSnapshotValue* it  = std::lower_bound( _pvalues, end, key );
+  bool found = ( it != end && !( key < *it ) );
+  if( found ) {
+    memcpy( value, it->value, VALUE_SIZE );
+    time = it->time;
+    ++_valueHits;
+  }
+  _lock.unlock();
+  return found;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Release the loaded snapshot file after record initialization
+//!
+//! From now on the snapshot file is written.
+//------------------------------------------------------------------------------
+void isegHalSnapshot::release() {
+  _lock.lock();
+  unmap();
+  _armed = true;
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Write the snapshot file
+//! @return      false in case of an error, otherwise true
+//!
+//! The properties of all items used by records and the last values
+//! read from isegHAL are written to a temporary file, which then
+//! replaces the snapshot file.
+//------------------------------------------------------------------------------
+bool isegHalSnapshot::save() {
+  _lock.lock();
+  if( !_armed || _file.empty() ) {
+    _lock.unlock();
+    return false;
+  }
+  epicsUInt64 start = epicsMonotonicGet();
+
+  std::vector< isegHalSnapshotProperty > properties;
+  std::vector< isegHalSnapshotValue > values;
+  isegHalPropertyCache::instance().snapshot( properties );
+  isegHalConnectionHandler::instance().snapshot( values );
+  std::sort( properties.begin(), properties.end() );
+  std::sort( values.begin(), values.end() );
+
+  isegHalSnapshotHeader header;
+  memset( &header, 0, sizeof( header ) );
+  memcpy( header.magic, "ISEGSNAP", sizeof( header.magic ) );
+  header.version      = snapshotVersion;
+  header.propertySize = sizeof( isegHalSnapshotProperty );
+  header.valueSize    = sizeof( isegHalSnapshotValue );
+  header.properties   = properties.size();
+  header.values       = values.size();
+  epicsTimeGetCurrent( &header.time );
+
+  std::string tmp = _file + ".tmp";
+  FILE* fp = fopen( tmp.c_str(), "wb" );
+  bool ok = ( NULL != fp );
+  if( ok ) {
+    ok &= ( fwrite( &header, sizeof( header ), 1, fp ) == 1 );
+    if( !properties.empty() )
+      ok &= ( fwrite( &properties[0], sizeof( isegHalSnapshotProperty ), properties.size(), fp ) == properties.size() );
+    if( !values.empty() )
+      ok &= ( fwrite( &values[0], sizeof( isegHalSnapshotValue ), values.size(), fp ) == values.size() );
+    ok &= ( fclose( fp ) == 0 );
+  }
+  if( ok ) ok = ( rename( tmp.c_str(), _file.c_str() ) == 0 );
+  if( !ok ) {
+    fprintf( stderr, "\033[31;1mCannot write snapshot file '%s': %s\033[0m\n", _file.c_str(), strerror( errno ) );
+    remove( tmp.c_str() );
+    ++_errors;
+  } else {
+    ++_saves;
+  }
+  _saveTime = ( epicsMonotonicGet() - start ) * 1e-9;
+  _lock.unlock();
+  return ok;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Print statistics of the snapshot file
+//! @param [in]  level   Level of detail
+//------------------------------------------------------------------------------
+void isegHalSnapshot::report( int level ) const {
+  _lock.lock();
+  if( _file.empty() ) {
+    _lock.unlock();
+    return;
+  }
+  printf( "Snapshot file '%s': written every %.1lf s and at exit\n", _file.c_str(), _period );
+  if( _loaded.secPastEpoch ) {
+    char time[40];
+    epicsTimeToStrftime( time, sizeof( time ), "%Y-%m-%d %H:%M:%S", &_loaded );
+    printf( "  loaded %lu properties and %lu values of %s, used for %lu properties and %lu values\n",
+            _loadedProperties, _loadedValues, time, _propertyHits, _valueHits );
+  }
+  printf( "  %lu snapshots written, %lu errors, last took %.3lf s\n", _saves, _errors, _saveTime );
+  _lock.unlock();
+}
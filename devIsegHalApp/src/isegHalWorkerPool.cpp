@@ -0,0 +1,244 @@
+//******************************************************************************
+// Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+//                    - Helmholtz-Institut Mainz
+//                    iseg Spezialelektronik GmbH
+//
+// This file is part of deviseg
+//
+// deviseg is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// deviseg is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+// version 2.1.0; October 16, 2026
+//
+//******************************************************************************
+
+//! @file isegHalWorkerPool.cpp
+//! @author F.Feldbauer
+//! @date 16 October 2026
+//! @brief Worker threads processing the records of the interfaces
+
+//_____ I N C L U D E S ________________________________________________________
+
+// ANSI C/C++ includes
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// EPICS includes
+#include <dbScan.h>
+#include <epicsAtomic.h>
+#include <epicsThread.h>
+
+// local includes
+#include "devIsegHalClasses.hpp"
+
+//_____ D E F I N I T I O N S __________________________________________________
+
+//_____ G L O B A L S __________________________________________________________
+
+//_____ L O C A L S ____________________________________________________________
+
+//------------------------------------------------------------------------------
+//! @brief       Name of a worker thread
+//! @param [in]  lane  Number of the lane
+//------------------------------------------------------------------------------
+static std::string workerName( unsigned lane ) {
+  char name[32];
+  sprintf( name, "isegHALwork:%u", lane );
+  return name;
+}
+
+//_____ F U N C T I O N S ______________________________________________________
+
+//------------------------------------------------------------------------------
+//! @brief       C'tor of isegHalWorker
+//! @param [in]  lane      Number of the lane
+//! @param [in]  priority  Priority of the worker thread
+//! @param [in]  depth     Maximum number of queued jobs
+//------------------------------------------------------------------------------
+isegHalWorker::isegHalWorker( unsigned lane, unsigned priority, size_t depth )
+  : thread( *this, workerName( lane ).c_str(), epicsThreadGetStackSize( epicsThreadStackMedium ), priority ),
+    _lane( lane ),
+    _depth( depth ),
+    _jobs(0),
+    _overflows(0),
+    _maxQueued(0)
+{}
+
+//------------------------------------------------------------------------------
+//! @brief       Run operation of worker thread
+//!
+//! Takes the jobs from the queue and processes the records of a scan group
+//! with scanIoImmediate, or a single record with dbProcess.
+//! A scan group whose records could not be scanned is handed back to its
+//! polling thread to be dispatched again.
+//! All records are processed by this thread, regardless of their PRIO.
+//! The priorities of a scan group are scanned from high to low, so records
+//! with a higher PRIO do not wait behind those with a lower one.
+//------------------------------------------------------------------------------
+void isegHalWorker::run() {
+  while( true ) {
+    _lock.lock();
+    if( _queue.empty() ) {
+      _lock.unlock();
+      _event.wait();
+      continue;
+    }
+    job_t job = _queue.front();
+    _queue.pop_front();
+    ++_jobs;
+    _lock.unlock();
+
+    if( job.pgroup ) {
+      bool requeue = false;
+      for( int prio = NUM_CALLBACK_PRIORITIES - 1; prio >= 0; --prio ) {
+        if( !( job.prioMask & ( 1u << prio ) ) ) continue;
+        // the completion callback is only called if records have been scanned,
+        // otherwise scanning does not run (yet) and the group stays pending
+        if( !( scanIoImmediate( job.pgroup->ioscanpvt, prio ) & ( 1u << prio ) ) ) {
+          epicsAtomicDecrIntT( &job.pgroup->inFlight );
+          requeue = true;
+        }
+      }
+      if( requeue ) job.pgroup->pthread->requeue( job.pgroup );
+    } else {
+      processReadback( job.pinfo );
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Queue a scan of a scan group
+//! @param [in]  pgroup    Address of the scan group
+//! @param [in]  prioMask  Priorities of the records to scan
+//! @return      false if the queue is full, otherwise true
+//------------------------------------------------------------------------------
+bool isegHalWorker::request( isegHalScanGroup* pgroup, unsigned prioMask ) {
+  job_t job = { pgroup, prioMask, NULL };
+  return push( job );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Queue processing of a record
+//! @param [in]  pinfo  Address of the record's private data structure
+//! @return      false if the queue is full, otherwise true
+//------------------------------------------------------------------------------
+bool isegHalWorker::request( devIsegHal_info_t* pinfo ) {
+  job_t job = { NULL, 0, pinfo };
+  return push( job );
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Add a job to the queue
+//! @param [in]  job  Job to add
+//! @return      false if the queue is full, otherwise true
+//------------------------------------------------------------------------------
+bool isegHalWorker::push( job_t const& job ) {
+  _lock.lock();
+  if( _queue.size() >= _depth ) {
+    ++_overflows;
+    _lock.unlock();
+    return false;
+  }
+  _queue.push_back( job );
+  if( _queue.size() > _maxQueued ) _maxQueued = _queue.size();
+  _lock.unlock();
+  _event.signal();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Print statistics of the worker
+//------------------------------------------------------------------------------
+void isegHalWorker::report() const {
+  _lock.lock();
+  printf( "    Lane %u: %lu jobs, %lu queued (max %lu of %lu), %lu overflows\n",
+          _lane, _jobs, (unsigned long)_queue.size(), (unsigned long)_maxQueued,
+          (unsigned long)_depth, _overflows );
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get instance of worker pool
+//! @return      Reference to the instance
+//------------------------------------------------------------------------------
+isegHalWorkerPool& isegHalWorkerPool::instance() {
+  static isegHalWorkerPool rInstance;
+  return rInstance;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       C'tor of isegHalWorkerPool
+//!
+//! By default no worker threads are used, the records are processed by
+//! the EPICS callback threads.
+//------------------------------------------------------------------------------
+isegHalWorkerPool::isegHalWorkerPool()
+  : _threads( 0 ),
+    _priority( epicsThreadPriorityScanLow - 1 ),
+    _depth( 1000 )
+{}
+
+//------------------------------------------------------------------------------
+//! @brief       Configure the worker pool
+//! @param [in]  threads   Number of worker threads, 0 to use the EPICS threads
+//! @param [in]  priority  Priority of the worker threads
+//! @param [in]  depth     Maximum number of queued jobs per lane
+//! @return      false if the pool is already running, otherwise true
+//------------------------------------------------------------------------------
+bool isegHalWorkerPool::configure( unsigned threads, unsigned priority, unsigned depth ) {
+  if( !_workers.empty() ) return false;
+  _threads  = threads;
+  _priority = priority;
+  _depth    = depth;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Start the worker threads
+//------------------------------------------------------------------------------
+void isegHalWorkerPool::start() {
+  if( !_workers.empty() ) return;
+  for( unsigned i = 0; i < _threads; ++i ) {
+    isegHalWorker* pworker = new isegHalWorker( i, _priority, _depth );
+    _workers.push_back( pworker );
+    pworker->thread.start();
+  }
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get the worker of a lane
+//! @param [in]  lane  Lane of an interface
+//! @return      Address of the worker, NULL if the EPICS threads are used
+//------------------------------------------------------------------------------
+isegHalWorker* isegHalWorkerPool::worker( unsigned lane ) {
+  if( _workers.empty() ) return NULL;
+  return _workers[ lane % _workers.size() ];
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Print statistics of the worker pool
+//! @param [in]  level   Level of detail
+//------------------------------------------------------------------------------
+void isegHalWorkerPool::report( int level ) const {
+  if( _workers.empty() ) {
+    printf( "isegHAL worker pool: not used, records are processed by the EPICS scan threads\n" );
+    return;
+  }
+  printf( "isegHAL worker pool: %lu threads with priority %u\n",
+          (unsigned long)_workers.size(), _priority );
+  if( level < 1 ) return;
+  std::vector< isegHalWorker* >::const_iterator it = _workers.begin();
+  for( ; it != _workers.end(); ++it ) (*it)->report();
+}
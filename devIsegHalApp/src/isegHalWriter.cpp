@@ -0,0 +1,401 @@
+//******************************************************************************
+// Copyright (C) 2026 Florian Feldbauer <f.feldbauer@him.uni-mainz.de>
+//                    - Helmholtz-Institut Mainz
+//                    iseg Spezialelektronik GmbH
+//
+// This file is part of deviseg
+//
+// deviseg is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// deviseg is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+// version 2.1.0; October 16, 2026
+//
+//******************************************************************************
+
+//! @file isegHalWriter.cpp
+//! @author F.Feldbauer
+//! @date 16 October 2026
+//! @brief Writer thread of an interface
+
+//_____ I N C L U D E S ________________________________________________________
+
+// ANSI C/C++ includes
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// EPICS includes
+#include <callback.h>
+#include <epicsAtomic.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+
+// local includes
+#include "devIsegHalClasses.hpp"
+#include "devIsegHalParse.h"
+
+//_____ D E F I N I T I O N S __________________________________________________
+
+//_____ G L O B A L S __________________________________________________________
+
+//_____ L O C A L S ____________________________________________________________
+
+//! Time in seconds the writer uses the last written value of a register
+//! for read-modify-write, before isegHAL has read back the new value
+static const double registerHold = 2.;
+
+//_____ F U N C T I O N S ______________________________________________________
+
+//------------------------------------------------------------------------------
+//! @brief       C'tor of isegHalWriter
+//! @param [in]  interface  deviseg internal name of the interface handle
+//! @param [in]  depth      Maximum number of queued writes
+//------------------------------------------------------------------------------
+isegHalWriter::isegHalWriter( std::string const& interface, size_t depth )
+  : thread( *this, ( "isegHALwrite:" + interface ).c_str(), epicsThreadGetStackSize( epicsThreadStackSmall ), 50 ),
+    _depth( depth ),
+    _window( 0. ),
+    _writes(0),
+    _errors(0),
+    _overflows(0),
+    _elided(0),
+    _registerWrites(0),
+    _deferredCompletions(0),
+    _maxQueued(0),
+    _sumQueued(0.)
+{}
+
+//------------------------------------------------------------------------------
+//! @brief       Run operation of writer thread
+//!
+//! Takes the writes from the queue in order, writes the value to isegHAL
+//! and requests the completion of the record.
+//! Writes within their write window are held back until the window expired.
+//! Their records are already completed, so a failed write is latched on
+//! the record (the array record for elements) and the record is processed
+//! as readback to raise the alarm.
+//! Completions which cannot be requested because the callback queue is
+//! full are retried, the record would otherwise stay active forever.
+//------------------------------------------------------------------------------
+void isegHalWriter::run() {
+  while( true ) {
+    bool retry = !complete();
+    _lock.lock();
+    if( _queue.empty() ) {
+      _lock.unlock();
+      if( retry ) _event.wait( dispatchRetry );
+      else        _event.wait();
+      continue;
+    }
+    epicsUInt64 current = epicsMonotonicGet();
+    if( _queue.front().due > current ) {
+      double wait = ( _queue.front().due - current ) * 1e-9;
+      _lock.unlock();
+      if( retry && wait > dispatchRetry ) wait = dispatchRetry;
+      _event.wait( wait );
+      continue;
+    }
+    job_t job = _queue.front();
+    _queue.pop_front();
+    _lock.unlock();
+
+    devIsegHal_info_t* pinfo = job.pinfo;
+    dbCommon* prec = pinfo->prec;
+    long status = OK;
+    const char* value = job.value;
+    char merged[VALUE_SIZE];
+    epicsUInt32 reg = 0;
+    if( pinfo->mask ) {
+      // read-modify-write of the bits of a register
+      if( !readRegister( pinfo, reg ) ) {
+        fprintf( stderr, "\033[31;1m%s: Error while reading register '%s'\033[0m\n", prec->name, pinfo->object );
+        status = ERROR;
+      } else {
+        reg = ( reg & ~pinfo->mask ) | ( ( strtoul( job.value, NULL, 10 ) << pinfo->shift ) & pinfo->mask );
+        sprintf( merged, "%u", reg );
+        value = merged;
+      }
+    }
+    if( OK == status && iseg_setItem( pinfo->interface, pinfo->object, value ) != ISEG_OK ) {
+      fprintf( stderr, "\033[31;1m%s: Error while writing value '%s': '%s'\033[0m\n",
+               prec->name, pinfo->object, value );
+      status = ERROR;
+    }
+    if( ERROR == status ) {
+      devIsegHal_info_t* powner = job.pcomplete;
+      if( !powner ) powner = pinfo->pparent ? static_cast< devIsegHal_info_t* >( pinfo->pparent ) : pinfo;
+      epicsAtomicIncrSizeT( &powner->writeErrors );
+      if( job.pcomplete ) {
+        job.pcomplete->writeStatus = ERROR;
+      } else {
+        // the record has already been completed, latch the error and
+        // process the record with the value of isegHAL to raise the alarm
+        epicsAtomicSetIntT( &powner->windowError, 1 );
+        epicsAtomicSetIntT( &powner->readback, 1 );
+        callbackSetPriority( powner->prec->prio, &powner->readbackCallback );
+        callbackRequest( &powner->readbackCallback );
+      }
+    }
+
+    // remember the written register until isegHAL has read it back
+    if( pinfo->mask && OK == status ) {
+      _registers[pinfo->object] = register_t( reg, epicsMonotonicGet() + (epicsUInt64)( registerHold * 1e9 ) );
+    } else if( OK == status ) {
+      _registers.erase( pinfo->object );
+    }
+    double latency = ( epicsMonotonicGet() - job.queued ) * 1e-9;
+
+    // read back the written item and its related items soon
+    if( OK == status ) pollerOf( pinfo )->follow( pinfo->object );
+
+    _lock.lock();
+    ++_writes;
+    if( pinfo->mask ) ++_registerWrites;
+    if( ERROR == status ) ++_errors;
+    _latency.add( latency );
+    _lock.unlock();
+
+    if( !job.last ) continue;
+
+    // process the record again to complete the write
+    _completions.push_back( job.pcomplete );
+  }
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Request the completion of the written records
+//! @return      false if completions are left for a retry, otherwise true
+//!
+//! The records are processed again by a callback in the order of their
+//! writes. If the callback queue is full, the remaining records are kept
+//! and retried later.
+//------------------------------------------------------------------------------
+bool isegHalWriter::complete() {
+  std::vector< devIsegHal_info_t* >::iterator it = _completions.begin();
+  for( ; it != _completions.end(); ++it ) {
+    dbCommon* prec = (*it)->prec;
+    if( 0 != callbackRequestProcessCallback( &(*it)->callback, prec->prio, prec ) ) break;
+  }
+  bool done = ( it == _completions.end() );
+  _completions.erase( _completions.begin(), it );
+  if( !done ) {
+    _lock.lock();
+    ++_deferredCompletions;
+    _lock.unlock();
+  }
+  return done;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Current value of a register for read-modify-write
+//! @param [in]  pinfo  Address of the private data of the writing record
+//! @param [out] value  Value of the register
+//! @return      false if the register cannot be read, otherwise true
+//!
+//! A register written shortly before is taken from the last write,
+//! since isegHAL reads back the new value only with a later cycle.
+//------------------------------------------------------------------------------
+bool isegHalWriter::readRegister( const devIsegHal_info_t* pinfo, epicsUInt32& value ) {
+  std::map< std::string, register_t >::iterator it = _registers.find( pinfo->object );
+  if( it != _registers.end() ) {
+    if( it->second.second > epicsMonotonicGet() ) {
+      value = it->second.first;
+      return true;
+    }
+    _registers.erase( it );
+  }
+
+  IsegItem item = iseg_getItem( pinfo->interface, pinfo->object );
+  if( strcmp( item.quality, ISEG_ITEM_QUALITY_OK ) != 0 ) return false;
+  devIsegHal_value_t reg;
+  reg.type = pinfo->value.type;
+  memcpy( reg.str, item.value, VALUE_SIZE );
+  devIsegHalParseValue( &reg );
+  if( !reg.valid ) return false;
+  value = reg.uval;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Queue a write, the record is completed after the write
+//! @param [in]  pinfo  Address of the record's private data structure
+//! @param [in]  value  Value cstring to write
+//! @return      false if the queue is full, otherwise true
+//------------------------------------------------------------------------------
+bool isegHalWriter::request( devIsegHal_info_t* pinfo, const char* value ) {
+  job_t job;
+  job.pinfo    = pinfo;
+  strncpy( job.value, value, VALUE_SIZE );
+  job.value[VALUE_SIZE - 1] = '\0';
+  job.queued    = epicsMonotonicGet();
+  job.due       = job.queued;
+  job.pcomplete = pinfo;
+  job.last      = true;
+
+  _lock.lock();
+  bool queued = push( job );
+  _lock.unlock();
+  if( queued ) _event.signal();
+  return queued;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Queue the writes of the elements of an array record
+//! @param [in]  pinfo     Address of the array record's private data structure
+//! @param [in]  elements  Private data of the elements to write
+//! @param [in]  values    Values of the elements
+//! @return      false if the queue cannot take all writes, otherwise true
+//!
+//! The writes are queued as one batch, the record is completed after
+//! the last write of the batch.
+//------------------------------------------------------------------------------
+bool isegHalWriter::request( devIsegHal_info_t* pinfo, std::vector< devIsegHal_info_t* > const& elements,
+                             std::vector< devIsegHal_value_t > const& values ) {
+  if( elements.empty() ) return false;
+
+  job_t job;
+  job.queued    = epicsMonotonicGet();
+  job.due       = job.queued;
+  job.pcomplete = pinfo;
+
+  _lock.lock();
+  if( _queue.size() + elements.size() > _depth ) {
+    ++_overflows;
+    _lock.unlock();
+    return false;
+  }
+  for( size_t i = 0; i < elements.size(); ++i ) {
+    job.pinfo = elements[i];
+    strncpy( job.value, values[i].str, VALUE_SIZE );
+    job.value[VALUE_SIZE - 1] = '\0';
+    job.last  = ( i + 1 == elements.size() );
+    push( job );
+  }
+  _lock.unlock();
+  _event.signal();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Queue a write within the write window
+//! @param [in]  pinfo  Address of the record's private data structure
+//! @param [in]  value  Value cstring to write
+//! @return      false if the queue is full, otherwise true
+//!
+//! If a write to the same object is still held back, its value is
+//! replaced and the previous value is elided. Otherwise the write is
+//! queued to be written once the write window expired.
+//------------------------------------------------------------------------------
+bool isegHalWriter::post( devIsegHal_info_t* pinfo, const char* value ) {
+  _lock.lock();
+  std::deque< job_t >::iterator it = _queue.begin();
+  for( ; it != _queue.end(); ++it ) {
+    if( it->pcomplete || strcmp( it->pinfo->object, pinfo->object ) != 0 ) continue;
+    // bits of a register only replace writes of the same bits
+    if( it->pinfo->mask != pinfo->mask || it->pinfo->shift != pinfo->shift ) continue;
+    it->pinfo = pinfo;
+    strncpy( it->value, value, VALUE_SIZE );
+    it->value[VALUE_SIZE - 1] = '\0';
+    ++_elided;
+    _lock.unlock();
+    return true;
+  }
+
+  job_t job;
+  job.pinfo    = pinfo;
+  strncpy( job.value, value, VALUE_SIZE );
+  job.value[VALUE_SIZE - 1] = '\0';
+  job.queued   = epicsMonotonicGet();
+  job.due       = job.queued + (epicsUInt64)( _window * 1e9 );
+  job.pcomplete = NULL;
+  job.last      = false;
+  bool queued = push( job );
+  _lock.unlock();
+  if( queued ) _event.signal();
+  return queued;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Add a write to the queue
+//! @param [in]  job  Write to add
+//! @return      false if the queue is full, otherwise true
+//!
+//! Must be called with the lock held.
+//------------------------------------------------------------------------------
+bool isegHalWriter::push( job_t& job ) {
+  if( _queue.size() >= _depth ) {
+    ++_overflows;
+    return false;
+  }
+  _queue.push_back( job );
+  _sumQueued += _queue.size();
+  if( _queue.size() > _maxQueued ) _maxQueued = _queue.size();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Print statistics of the writer thread
+//! @param [in]  level   Level of detail
+//------------------------------------------------------------------------------
+void isegHalWriter::report( int level ) const {
+  _lock.lock();
+  unsigned long requests = _writes + (unsigned long)_queue.size();
+  printf( "  Writer thread: %lu writes, %lu errors, %lu queued (mean %.2lf, max %lu of %lu), %lu overflows\n",
+          _writes, _errors, (unsigned long)_queue.size(), requests ? _sumQueued / requests : 0.,
+          (unsigned long)_maxQueued, (unsigned long)_depth, _overflows );
+  if( _window > 0. || _elided ) {
+    printf( "    write window %.3lf s, %lu writes elided\n", _window, _elided );
+  }
+  if( _registerWrites ) {
+    printf( "    %lu read-modify-writes of register bits\n", _registerWrites );
+  }
+  if( _deferredCompletions ) {
+    printf( "    %lu completions deferred by a full callback queue\n", _deferredCompletions );
+  }
+  printf( "    write latency: last %.6lf s, max %.6lf s, mean %.6lf s\n",
+          _latency.last(), _latency.max(), _latency.mean() );
+  if( level > 1 ) _latency.report( "Write latency" );
+  _lock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//! @brief       Get statistics of the writer thread
+//! @param [in]  name   Name of the statistic
+//! @param [out] value  Current value of the statistic
+//! @return      false if the statistic is unknown, otherwise true
+//!
+//! Possible statistics are:
+//! Writes, WriteErrors, WriteElided, WriteQueue, WriteQueueMax,
+//! WriteLatency, WriteLatencyMax, WriteLatencyMean, RegisterWrites
+//! and WriteCompletionsDeferred
+//------------------------------------------------------------------------------
+bool isegHalWriter::statistic( std::string const& name, double& value ) const {
+  bool found = true;
+  _lock.lock();
+  if(      "Writes"           == name ) value = _writes;
+  else if( "WriteErrors"      == name ) value = _errors;
+  else if( "WriteElided"      == name ) value = _elided;
+  else if( "WriteQueue"       == name ) value = _queue.size();
+  else if( "WriteQueueMax"    == name ) value = _maxQueued;
+  else if( "WriteLatency"     == name ) value = _latency.last();
+  else if( "WriteLatencyMax"  == name ) value = _latency.max();
+  else if( "WriteLatencyMean" == name ) value = _latency.mean();
+  else if( "RegisterWrites"   == name ) value = _registerWrites;
+  else if( "WriteCompletionsDeferred" == name ) value = _deferredCompletions;
+  else found = false;
+  _lock.unlock();
+  return found;
+}